@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "utils.h"
+#include "arena.h"
+
+#define ARENA_ALIGN 64      // cache line, and enough for any vector load
+
+/* the arena trial_malloc allocates from, one per thread */
+static __thread Arena *trial_arena = NULL;
+
+/* internal function prototypes */
+size_t align_size(size_t size);
+
+/* function definitions */
+
+Arena *create_arena(size_t capacity) {
+    Arena *a = malloc(sizeof(Arena));
+    if (a == NULL)
+        error(1,"create_arena: cannot malloc Arena\n","");
+    a->capacity = align_size(capacity);
+    a->base = NULL;
+    if (a->capacity > 0 && 
+        posix_memalign((void **) &a->base, ARENA_ALIGN, a->capacity) != 0)
+        error(1,"create_arena: cannot allocate arena block\n","");
+    a->used = 0;
+    a->last = 0;
+    a->needed = 0;
+    return a;
+}
+
+void destroy_arena(Arena *a) {
+    if (trial_arena == a)
+        trial_arena = NULL;
+    free(a->base);
+    free(a);
+}
+
+/*
+ * reset_arena
+ * Free everything allocated from a. If the trial since the last reset 
+ * needed more than a holds, replace the block with one that large (plus a
+ * little, as trials of the same size differ slightly).
+ */
+void reset_arena(Arena *a) {
+    if (a->needed > a->capacity) {
+        free(a->base);
+        a->capacity = align_size(a->needed + a->needed / 16);
+        if (posix_memalign((void **) &a->base, ARENA_ALIGN, a->capacity) != 0)
+            error(1,"reset_arena: cannot allocate arena block\n","");
+    }
+    a->used = 0;
+    a->last = 0;
+    a->needed = 0;
+}
+
+void set_trial_arena(Arena *a) {
+    trial_arena = a;
+}
+
+Arena *get_trial_arena(void) {
+    return trial_arena;
+}
+
+void *trial_malloc(size_t size) {
+    Arena *a = trial_arena;
+    if (a == NULL)
+        return malloc(size);
+    size = align_size(size > 0 ? size : 1);
+    a->needed += size;
+    if (size > a->capacity - a->used)
+        return malloc(size);    // the next reset makes room for it
+    a->last = a->used;
+    a->used += size;
+    return a->base + a->last;
+}
+
+void trial_free(void *p) {
+    Arena *a = trial_arena;
+    char *cp = p;
+    if (a == NULL || a->base == NULL || 
+        cp < a->base || cp >= a->base + a->capacity) {
+        free(p);
+        return;
+    }
+    if (cp == a->base + a->last && a->used > a->last) {
+        // the latest allocation can be given back at once
+        a->needed -= a->used - a->last;
+        a->used = a->last;
+    }
+}
+
+size_t align_size(size_t size) {
+    return (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+}
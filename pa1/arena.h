@@ -0,0 +1,41 @@
+#include <stddef.h>
+
+typedef struct arena Arena;
+
+/*
+ * a bump allocator for the buffers of one trial: the graph, its edge 
+ * list, the union-find and the MST. Allocation moves used forward and 
+ * reset_arena takes it back to 0, so the same pages serve every trial.
+ * Requests that do not fit fall back to malloc, and the next reset grows 
+ * the block to what the trial needed, so after the largest trial every 
+ * request fits.
+ */
+struct arena {
+    char *base;
+    size_t capacity;
+    size_t used;
+    size_t last;            // offset of the latest allocation
+    size_t needed;          // bytes asked for since the last reset
+};
+
+Arena *create_arena(size_t capacity);
+void destroy_arena(Arena *a);
+void reset_arena(Arena *a);
+
+/*
+ * set_trial_arena
+ * make trial_malloc on the calling thread allocate from a, or from the 
+ * heap if a is NULL. Like the random streams, the arena is per thread.
+ */
+void set_trial_arena(Arena *a);
+Arena *get_trial_arena(void);
+
+/*
+ * trial_malloc, trial_free
+ * malloc and free through the calling thread's arena. trial_free releases
+ * only the latest arena allocation (the rest go at the next reset) and 
+ * passes pointers from outside the arena on to free, so it must run on 
+ * the thread that allocated.
+ */
+void *trial_malloc(size_t size);
+void trial_free(void *p);
@@ -0,0 +1,309 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "random_graph.h"
+#include "graph_file.h"
+#include "engine.h"
+#include "parallel.h"
+#include "planner.h"
+#include "batch.h"
+
+#define MAX_JOB_LINE 256
+
+typedef struct batch_job BatchJob;
+typedef struct batch_item BatchItem;
+typedef struct batch Batch;
+
+/* internal structures */
+
+/* one job line and the weights of its trials so far */
+struct batch_job {
+    unsigned long seed;
+    int num_vertices;
+    int numtrials;
+    int dim;
+    Engine engine;
+    EdgeWeight *weight;     // MST weight of each trial
+    int trials_left;        // trials not yet solved, under result_lock
+    BatchJob *next;         // the job read after this one
+};
+
+/* a generated graph on its way from a producer to a consumer */
+struct batch_item {
+    BatchJob *job;
+    int trial;
+    Graph *g;
+};
+
+struct batch {
+    FILE *in;
+    Engine engine;
+    double mem_limit;
+    int num_producers;
+    int next_role;          // threads below num_producers produce
+
+    /* producers: the job being handed out, read under read_lock */
+    BatchJob *current;
+    int next_trial;
+    int line_number;
+    pthread_mutex_t read_lock;
+
+    /* the bounded queue of generated graphs, a ring of capacity items */
+    BatchItem *queue;
+    int capacity;
+    int head;               // position of the oldest item
+    int count;
+    int producers_left;     // consumers stop once this and count are 0
+    pthread_mutex_t queue_lock;
+    pthread_cond_t not_full;
+    pthread_cond_t not_empty;
+
+    /* the jobs read but not yet printed, in input order */
+    BatchJob *first;
+    BatchJob *last;
+    pthread_mutex_t result_lock;
+};
+
+/* internal function prototypes */
+void *batch_worker(void *arg);
+void produce_graphs(Batch *b);
+void consume_graphs(Batch *b);
+int next_batch_trial(Batch *b, BatchItem *item);
+BatchJob *read_batch_job(Batch *b);
+void push_batch_item(Batch *b, BatchItem *item);
+int pop_batch_item(Batch *b, BatchItem *item);
+void finish_batch_trial(Batch *b, BatchJob *job);
+
+/* function definitions */
+
+void run_batch(FILE *in, Engine e, int num_producers, int num_consumers,
+               double mem_limit) {
+    Batch b;
+    b.in = in;
+    b.engine = e;
+    b.mem_limit = mem_limit;
+    b.num_producers = num_producers;
+    b.next_role = 0;
+    b.current = NULL;
+    b.next_trial = 0;
+    b.line_number = 0;
+    // one graph waiting for each consumer keeps them all busy
+    b.capacity = num_consumers;
+    b.queue = malloc(b.capacity * sizeof(BatchItem));
+    if (b.queue == NULL)
+        error(1,"run_batch: cannot malloc queue\n","");
+    b.head = 0;
+    b.count = 0;
+    b.producers_left = num_producers;
+    b.first = NULL;
+    b.last = NULL;
+    pthread_mutex_init(&b.read_lock, NULL);
+    pthread_mutex_init(&b.queue_lock, NULL);
+    pthread_cond_init(&b.not_full, NULL);
+    pthread_cond_init(&b.not_empty, NULL);
+    pthread_mutex_init(&b.result_lock, NULL);
+
+    run_parallel(num_producers + num_consumers, batch_worker, &b);
+
+    pthread_mutex_destroy(&b.result_lock);
+    pthread_cond_destroy(&b.not_empty);
+    pthread_cond_destroy(&b.not_full);
+    pthread_mutex_destroy(&b.queue_lock);
+    pthread_mutex_destroy(&b.read_lock);
+    free(b.queue);
+}
+
+/*
+ * batch_worker
+ * The first num_producers threads to start generate, the rest solve.
+ */
+void *batch_worker(void *arg) {
+    Batch *b = arg;
+    if (__atomic_fetch_add(&b->next_role, 1, __ATOMIC_RELAXED)
+        < b->num_producers)
+        produce_graphs(b);
+    else
+        consume_graphs(b);
+    return NULL;
+}
+
+/*
+ * produce_graphs
+ * Generate trial after trial into the queue, trial i of a job from random
+ * stream i of its seed, until the jobs run out. Producers allocate from
+ * the heap, not an arena, since the graphs are freed on other threads.
+ */
+void produce_graphs(Batch *b) {
+    BatchItem item;
+    while (next_batch_trial(b, &item)) {
+        set_random_stream(item.job->seed, item.trial);
+        item.g = create_engine_graph(item.job->engine, item.job->dim,
+                                     item.job->num_vertices);
+        push_batch_item(b, &item);
+    }
+    pthread_mutex_lock(&b->queue_lock);
+    if (--b->producers_left == 0)
+        pthread_cond_broadcast(&b->not_empty);
+    pthread_mutex_unlock(&b->queue_lock);
+}
+
+void consume_graphs(Batch *b) {
+    Arena *arena = create_arena(0);
+    set_trial_arena(arena);
+    BatchItem item;
+    while (pop_batch_item(b, &item)) {
+        reset_arena(arena);
+        // the engines that draw weights while solving start the stream
+        // the producer left untouched
+        set_random_stream(item.job->seed, item.trial);
+        item.job->weight[item.trial] = engine_mst_weight(item.job->engine,
+                                                         item.g);
+        finish_batch_trial(b, item.job);
+    }
+    set_trial_arena(NULL);
+    destroy_arena(arena);
+}
+
+/*
+ * next_batch_trial
+ * Hand out the next trial of the current job, reading a new job once the
+ * last one has handed out all of its trials.
+ * Returns: 0 once there are no jobs left.
+ */
+int next_batch_trial(Batch *b, BatchItem *item) {
+    pthread_mutex_lock(&b->read_lock);
+    if (b->current == NULL)
+        b->current = read_batch_job(b);
+    if (b->current == NULL) {
+        pthread_mutex_unlock(&b->read_lock);
+        return 0;
+    }
+    item->job = b->current;
+    item->trial = b->next_trial++;
+    if (b->next_trial == b->current->numtrials) {
+        // the job is freed once its trials are solved, so let go of it
+        b->current = NULL;
+        b->next_trial = 0;
+    }
+    pthread_mutex_unlock(&b->read_lock);
+    return 1;
+}
+
+/*
+ * read_batch_job
+ * Read the next job line, check it as randmst checks its arguments and
+ * queue the job for printing. Runs under read_lock.
+ * Returns: the job, NULL at the end of the input.
+ */
+BatchJob *read_batch_job(Batch *b) {
+    char line[MAX_JOB_LINE], name[32], where[32];
+    unsigned long flag;
+    int n, numtrials, dim, fields;
+    do {
+        if (fgets(line, sizeof(line), b->in) == NULL)
+            return NULL;
+        b->line_number++;
+        fields = sscanf(line, "%lu %d %d %d %31s", &flag, &n, &numtrials,
+                        &dim, name);
+    } while (fields <= 0 || line[strspn(line, " \t")] == '#');
+
+    sprintf(where, "line %d\n", b->line_number);
+    if (fields < 4)
+        error(2,"randmst: bad job on", where);
+    if (!is_random_dimension(dim))
+        error(2,"randmst: dimension must be 0 or 2 to 64 on", where);
+    if (n < 2 || numtrials < 1)
+        error(2,"randmst: numpoints must be at least 2 and numtrials "
+              "positive on", where);
+
+    BatchJob *job = malloc(sizeof(BatchJob));
+    if (job == NULL)
+        error(1,"read_batch_job: cannot malloc job\n","");
+    job->seed = (flag != 0) ? flag : (unsigned long) time(NULL);
+    job->num_vertices = n;
+    job->numtrials = numtrials;
+    job->dim = dim;
+    job->engine = (fields == 5) ? parse_engine(name) : b->engine;
+    if (job->engine == ENGINE_AUTO)
+        job->engine = plan_engine(dim, n, b->mem_limit, stderr);
+    job->weight = create_edge_weights(numtrials);
+    job->trials_left = numtrials;
+    job->next = NULL;
+
+    pthread_mutex_lock(&b->result_lock);
+    if (b->last == NULL)
+        b->first = job;
+    else
+        b->last->next = job;
+    b->last = job;
+    pthread_mutex_unlock(&b->result_lock);
+    return job;
+}
+
+void push_batch_item(Batch *b, BatchItem *item) {
+    pthread_mutex_lock(&b->queue_lock);
+    while (b->count == b->capacity)
+        pthread_cond_wait(&b->not_full, &b->queue_lock);
+    b->queue[(b->head + b->count) % b->capacity] = *item;
+    b->count++;
+    pthread_cond_signal(&b->not_empty);
+    pthread_mutex_unlock(&b->queue_lock);
+}
+
+/*
+ * pop_batch_item
+ * Take the oldest graph off the queue, waiting for one if need be.
+ * Returns: 0 once the queue is empty and every producer has finished.
+ */
+int pop_batch_item(Batch *b, BatchItem *item) {
+    pthread_mutex_lock(&b->queue_lock);
+    while (b->count == 0 && b->producers_left > 0)
+        pthread_cond_wait(&b->not_empty, &b->queue_lock);
+    if (b->count == 0) {
+        pthread_mutex_unlock(&b->queue_lock);
+        return 0;
+    }
+    *item = b->queue[b->head];
+    b->head = (b->head + 1) % b->capacity;
+    b->count--;
+    pthread_cond_signal(&b->not_full);
+    pthread_mutex_unlock(&b->queue_lock);
+    return 1;
+}
+
+/*
+ * finish_batch_trial
+ * Count a solved trial of job and print every finished job at the front
+ * of the list. Weights are summed in trial order, as run_trials does, so
+ * a job prints the same mean as randmst run on its line alone.
+ */
+void finish_batch_trial(Batch *b, BatchJob *job) {
+    pthread_mutex_lock(&b->result_lock);
+    job->trials_left--;
+    while (b->first != NULL && b->first->trials_left == 0) {
+        job = b->first;
+        double avg = 0.0;
+        int i;
+        for (i = 0; i < job->numtrials; i++)
+            avg = avg + job->weight[i];
+        avg = avg / job->numtrials;
+        // output: average numpoints numtrials dimension
+        printf("%f %d %d %d\n", avg, job->num_vertices, job->numtrials,
+               job->dim);
+        fflush(stdout);
+
+        b->first = job->next;
+        if (b->first == NULL)
+            b->last = NULL;
+        free(job->weight);
+        free(job);
+    }
+    pthread_mutex_unlock(&b->result_lock);
+}
@@ -0,0 +1,18 @@
+/*
+ * run_batch
+ * Read jobs from in, one per line as
+ *
+ *     seed numpoints numtrials dimension [engine]
+ *
+ * (blank lines and lines starting with # are skipped, engine defaults to
+ * e) and print one line per job, in job order, exactly as randmst with
+ * those arguments would. num_producers threads generate the trials'
+ * graphs into a queue of num_consumers graphs, which num_consumers
+ * threads take and solve, so generation of the next trials overlaps the
+ * MST of the current ones. Jobs are read as the producers need them and
+ * each result is printed as soon as its job and every earlier one are
+ * done, so in may be a pipe. mem_limit is the memory each graph in flight
+ * may use when an engine is planned for a job.
+ */
+void run_batch(FILE *in, Engine e, int num_producers, int num_consumers,
+               double mem_limit);
@@ -0,0 +1,375 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "utils.h"
+#include "graph.h"
+#include "random_graph.h"
+#include "kruskal.h"
+#include "radix_sort.h"
+#include "union_find.h"
+#include "graph_file.h"
+#include "engine.h"
+
+/*
+ * bench
+ * Time the phases of Kruskal on random graphs over a sweep of sizes and
+ * dimensions, and the whole of random_mst_weight for each engine asked
+ * for. Each (engine, dimension, n) point runs reps times, repetition r on
+ * random stream r of the seed, and every phase reports the median and
+ * interquartile range of its wall time and of its peak resident set.
+ */
+
+#define USAGE "usage: bench [-e engine,...] [-r reps] [-o csv|json] [-q] " \
+              "seed dimensions sizes\n" \
+              "  dimensions and sizes are comma separated, e.g. 0,2 1024,4096\n"
+
+#define MAX_LIST 64
+
+typedef struct sample Sample;
+typedef struct summary Summary;
+
+/* one measurement of a phase */
+struct sample {
+    double seconds;
+    long peak_kb;           // peak resident set while the phase ran
+};
+
+/* median and interquartile range over the repetitions of a phase */
+struct summary {
+    double time_median;
+    double time_iqr;
+    double rss_median;
+    double rss_iqr;
+};
+
+enum phase {
+    PHASE_COORDINATES,
+    PHASE_WEIGHTS,
+    PHASE_EDGE_LIST,
+    PHASE_SORT,
+    PHASE_UNION_FIND,
+    NUM_KRUSKAL_PHASES,
+    PHASE_TOTAL = NUM_KRUSKAL_PHASES,
+    NUM_PHASES
+};
+
+static char *phase_names[NUM_PHASES] = {
+    "coordinates", "weights", "edge_list", "sort", "union_find", "total"
+};
+
+/* internal function prototypes */
+int parse_int_list(char *s, int *list);
+double wall_time(void);
+int reset_peak_rss(void);
+long read_peak_rss(void);
+void begin_phase(Sample *s);
+void end_phase(Sample *s);
+void kruskal_phases(int dim, int n, Sample *phase);
+void engine_total(Engine e, int dim, int n, Sample *total);
+double quantile(double *sorted, int count, double q);
+int compare_double(const void *p, const void *q);
+void summarize(Sample *samples, int count, Summary *sum);
+void print_header(int json);
+void print_row(int json, int first, char *engine, int dim, int n,
+               char *phase, int reps, Summary *sum);
+
+/* set once at startup: 1 if /proc/self/clear_refs can reset VmHWM */
+static int can_reset_peak = 0;
+
+int main(int argc, char *argv[]) {
+    Engine engines[MAX_LIST];
+    int num_engines = 0;
+    int reps = 5, json = 0, squared = 0, opt;
+    char *name;
+    while ((opt = getopt(argc, argv, "e:r:o:q")) != -1) {
+        switch (opt) {
+            case 'e':
+                for (name = strtok(optarg, ","); name != NULL &&
+                     num_engines < MAX_LIST; name = strtok(NULL, ","))
+                    engines[num_engines++] = parse_engine(name);
+                break;
+            case 'r':
+                reps = atoi(optarg);
+                break;
+            case 'o':
+                if (strcmp(optarg, "json") == 0)
+                    json = 1;
+                else if (strcmp(optarg, "csv") == 0)
+                    json = 0;
+                else
+                    error(1,USAGE,"");
+                break;
+            case 'q':
+                squared = 1;
+                break;
+            default:
+                error(1,USAGE,"");
+        }
+    }
+    if (argc - optind != 3 || reps < 1)
+        error(1,USAGE,"");
+    argv += optind;
+    set_squared_distances(squared);
+
+    unsigned long seed = strtoul(argv[0], NULL, 10);
+    if (seed == 0)
+        seed = (unsigned long) time(NULL);
+    int dims[MAX_LIST], sizes[MAX_LIST], d, s;
+    int num_dims = parse_int_list(argv[1], dims);
+    int num_sizes = parse_int_list(argv[2], sizes);
+    if (num_dims == 0 || num_sizes == 0)
+        error(1,USAGE,"");
+    for (d = 0; d < num_dims; d++)
+        if (!is_random_dimension(dims[d]))
+            error(1,USAGE,"");
+    for (s = 0; s < num_sizes; s++)
+        if (sizes[s] < 2)
+            error(1,USAGE,"");
+
+#ifdef __GLIBC__
+    // keep big buffers in their own mappings so that freeing them gives
+    // the memory back, otherwise one phase's peak would carry into the next
+    mallopt(M_MMAP_THRESHOLD, 128 * 1024);
+    mallopt(M_TRIM_THRESHOLD, 128 * 1024);
+#endif
+    can_reset_peak = reset_peak_rss();
+    if (!can_reset_peak)
+        fprintf(stderr, "bench: cannot reset peak RSS, reporting the "
+                        "process peak instead\n");
+
+    Sample *samples = malloc(NUM_PHASES * reps * sizeof(Sample));
+    Sample *per_phase = malloc(reps * sizeof(Sample));
+    if (samples == NULL || per_phase == NULL)
+        error(1,"bench: could not malloc samples\n","");
+
+    Summary sum;
+    int first = 1, e, r, p;
+    print_header(json);
+    for (d = 0; d < num_dims; d++) {
+        for (s = 0; s < num_sizes; s++) {
+            int dim = dims[d], n = sizes[s];
+            for (r = 0; r < reps; r++) {
+                set_random_stream(seed, r);
+                kruskal_phases(dim, n, &samples[r * NUM_PHASES]);
+            }
+            for (p = 0; p < NUM_KRUSKAL_PHASES; p++) {
+                for (r = 0; r < reps; r++)
+                    per_phase[r] = samples[r * NUM_PHASES + p];
+                summarize(per_phase, reps, &sum);
+                print_row(json, first, "kruskal", dim, n, phase_names[p],
+                          reps, &sum);
+                first = 0;
+            }
+            for (e = 0; e < num_engines; e++) {
+                for (r = 0; r < reps; r++) {
+                    set_random_stream(seed, r);
+                    engine_total(engines[e], dim, n, &per_phase[r]);
+                }
+                summarize(per_phase, reps, &sum);
+                print_row(json, first, get_engine_name(engines[e]), dim, n,
+                          phase_names[PHASE_TOTAL], reps, &sum);
+                first = 0;
+            }
+        }
+    }
+    if (json)
+        printf("\n]\n");
+
+    free(per_phase);
+    free(samples);
+    return 0;
+}
+
+int parse_int_list(char *s, int *list) {
+    int count = 0;
+    char *item;
+    for (item = strtok(s, ","); item != NULL && count < MAX_LIST;
+         item = strtok(NULL, ","))
+        list[count++] = atoi(item);
+    return count;
+}
+
+double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * reset_peak_rss
+ * Reset the kernel's resident set high water mark (VmHWM) to the current
+ * resident set, so the next read sees the peak of one phase only.
+ * Returns 0 if the kernel does not allow it.
+ */
+int reset_peak_rss(void) {
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (f == NULL)
+        return 0;
+    int ok = (fputs("5", f) >= 0);
+    if (fclose(f) != 0)
+        ok = 0;
+    return ok;
+}
+
+/*
+ * read_peak_rss
+ * Return the resident set high water mark in kilobytes, from VmHWM if
+ * available and from getrusage otherwise.
+ */
+long read_peak_rss(void) {
+    char line[128];
+    long kb = -1;
+    FILE *f = fopen("/proc/self/status", "r");
+    if (f != NULL) {
+        while (fgets(line, sizeof(line), f) != NULL) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                kb = atol(line + 6);
+                break;
+            }
+        }
+        fclose(f);
+    }
+    if (kb < 0) {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        kb = usage.ru_maxrss;
+    }
+    return kb;
+}
+
+void begin_phase(Sample *s) {
+    if (can_reset_peak)
+        reset_peak_rss();
+    s->seconds = wall_time();
+}
+
+void end_phase(Sample *s) {
+    s->seconds = wall_time() - s->seconds;
+    s->peak_kb = read_peak_rss();
+}
+
+/*
+ * kruskal_phases
+ * Build a random graph and run Kruskal on it as kruskal() does, timing
+ * each step into phase[0 .. NUM_KRUSKAL_PHASES - 1]. Dimension 0 has no
+ * coordinates, so its coordinate phase only creates the graph.
+ */
+void kruskal_phases(int dim, int n, Sample *phase) {
+    Graph *g;
+    begin_phase(&phase[PHASE_COORDINATES]);
+    g = create_graph(n);
+    set_squared_weights(g, get_squared_distances() && dim != 0);
+    if (dim != 0)
+        set_random_coordinates(g, dim);
+    end_phase(&phase[PHASE_COORDINATES]);
+
+    begin_phase(&phase[PHASE_WEIGHTS]);
+    create_edge_weight_matrix(g);
+    if (dim == 0)
+        make_interval_edge_weights(g);
+    else
+        make_distance_edge_weights(g);
+    end_phase(&phase[PHASE_WEIGHTS]);
+
+    begin_phase(&phase[PHASE_EDGE_LIST]);
+    EdgeList *el = make_graph_edge_list(g, FLT_MAX);
+    end_phase(&phase[PHASE_EDGE_LIST]);
+
+    begin_phase(&phase[PHASE_SORT]);
+    radix_sort_edges(get_edges(el), get_num_edges(el));
+    end_phase(&phase[PHASE_SORT]);
+
+    begin_phase(&phase[PHASE_UNION_FIND]);
+    UnionFind *uf = create_union_find(n);
+    Edge *edges = get_edges(el);
+    long i;
+    int accepted = 0;
+    // stop at a spanning tree, as kruskal_edge_list does
+    for (i = 0; i < get_num_edges(el) && accepted < n - 1; i++)
+        accepted += uf_union(uf, get_start_index(&edges[i]), 
+                             get_end_index(&edges[i]));
+    destroy_union_find(uf);
+    end_phase(&phase[PHASE_UNION_FIND]);
+
+    destroy_edge_list(el);
+    destroy_graph(g);
+}
+
+void engine_total(Engine e, int dim, int n, Sample *total) {
+    begin_phase(total);
+    random_mst_weight(e, dim, n);
+    end_phase(total);
+}
+
+int compare_double(const void *p, const void *q) {
+    double a = *(const double *) p, b = *(const double *) q;
+    return (a > b) - (a < b);
+}
+
+/*
+ * quantile
+ * The q-quantile of count sorted values, interpolating linearly between
+ * the two nearest ranks.
+ */
+double quantile(double *sorted, int count, double q) {
+    double rank = q * (count - 1);
+    int lo = (int) rank;
+    if (lo + 1 >= count)
+        return sorted[count - 1];
+    return sorted[lo] + (rank - lo) * (sorted[lo + 1] - sorted[lo]);
+}
+
+void summarize(Sample *samples, int count, Summary *sum) {
+    double *values = malloc(count * sizeof(double));
+    if (values == NULL)
+        error(1,"bench: could not malloc values\n","");
+    int i;
+
+    for (i = 0; i < count; i++)
+        values[i] = samples[i].seconds;
+    qsort(values, count, sizeof(double), compare_double);
+    sum->time_median = quantile(values, count, 0.5);
+    sum->time_iqr = quantile(values, count, 0.75) -
+                    quantile(values, count, 0.25);
+
+    for (i = 0; i < count; i++)
+        values[i] = samples[i].peak_kb;
+    qsort(values, count, sizeof(double), compare_double);
+    sum->rss_median = quantile(values, count, 0.5);
+    sum->rss_iqr = quantile(values, count, 0.75) -
+                   quantile(values, count, 0.25);
+
+    free(values);
+}
+
+void print_header(int json) {
+    if (json)
+        printf("[");
+    else
+        printf("engine,dimension,n,phase,reps,time_median_s,time_iqr_s,"
+               "peak_rss_median_kb,peak_rss_iqr_kb\n");
+}
+
+void print_row(int json, int first, char *engine, int dim, int n,
+               char *phase, int reps, Summary *sum) {
+    if (json) {
+        printf("%s\n  {\"engine\": \"%s\", \"dimension\": %d, \"n\": %d, "
+               "\"phase\": \"%s\", \"reps\": %d, \"time_median_s\": %.6f, "
+               "\"time_iqr_s\": %.6f, \"peak_rss_median_kb\": %.0f, "
+               "\"peak_rss_iqr_kb\": %.0f}", first ? "" : ",", engine, dim,
+               n, phase, reps, sum->time_median, sum->time_iqr,
+               sum->rss_median, sum->rss_iqr);
+    } else {
+        printf("%s,%d,%d,%s,%d,%.6f,%.6f,%.0f,%.0f\n", engine, dim, n,
+               phase, reps, sum->time_median, sum->time_iqr,
+               sum->rss_median, sum->rss_iqr);
+    }
+}
@@ -0,0 +1,174 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "radix_sort.h"
+#include "union_find.h"
+#include "parallel.h"
+#include "boruvka.h"
+
+#define VERTICES_PER_TASK 64
+#define NO_EDGE UINT64_MAX
+
+typedef struct boruvka Boruvka;
+
+/* internal structures */
+struct boruvka {
+    Graph *g;
+    UnionFind *uf;
+    int num_vertices;
+    int *comp;              // component (union-find root) of each vertex
+    int *nearest;           // other end of each vertex's lightest edge out
+    EdgeWeight *nearest_cost;
+    uint64_t *best;         // per component: weight key << 32 | vertex
+    Edge *x;
+    int num_mst_edges;
+};
+
+/* internal function prototypes */
+void label_vertices(int task, void *arg);
+void find_lightest_edges(int task, void *arg);
+void join_components(Boruvka *b);
+void offer_edge(uint64_t *best, uint64_t candidate);
+void task_vertices(Boruvka *b, int task, int *begin, int *end);
+
+/* function definitions */
+
+Edge *parallel_boruvka(Graph *g) {
+    Boruvka b;
+    int n = get_num_vertices(g);
+    b.g = g;
+    b.num_vertices = n;
+    b.uf = create_union_find(n);
+    b.comp = malloc(n * sizeof(int));
+    b.nearest = malloc(n * sizeof(int));
+    b.nearest_cost = create_edge_weights(n);
+    b.best = malloc(n * sizeof(uint64_t));
+    if (b.comp == NULL || b.nearest == NULL || b.best == NULL)
+        error(1,"parallel_boruvka: cannot malloc vertex arrays\n","");
+    b.x = create_edge_array(n - 1);
+    b.num_mst_edges = 0;
+
+    int num_tasks = (n + VERTICES_PER_TASK - 1) / VERTICES_PER_TASK;
+    int num_threads = get_num_threads();
+    while (b.num_mst_edges < n - 1) {
+        parallel_for(num_tasks, num_threads, label_vertices, &b);
+        parallel_for(num_tasks, num_threads, find_lightest_edges, &b);
+        join_components(&b);
+    }
+
+    free(b.comp);
+    free(b.nearest);
+    free(b.nearest_cost);
+    free(b.best);
+    destroy_union_find(b.uf);
+    return b.x;
+}
+
+/*
+ * label_vertices
+ * start a round: record each vertex's component and clear the component
+ * minimums
+ */
+void label_vertices(int task, void *arg) {
+    Boruvka *b = arg;
+    int v, begin, end;
+    task_vertices(b, task, &begin, &end);
+    for (v = begin; v < end; v++) {
+        b->comp[v] = uf_find_concurrent(b->uf, v);
+        b->best[v] = NO_EDGE;
+    }
+}
+
+/*
+ * find_lightest_edges
+ * For each vertex find its lightest edge to another component, and offer
+ * it as the lightest edge out of the vertex's component. Ties are broken 
+ * by vertex index so every thread agrees on the winner.
+ */
+void find_lightest_edges(int task, void *arg) {
+    Boruvka *b = arg;
+    int v, w, c, best_w, begin, end;
+    EdgeWeight cost, best_cost;
+    Vertex *vp;
+    EdgeWeight *ewp;
+    task_vertices(b, task, &begin, &end);
+    for (v = begin; v < end; v++) {
+        vp = get_vertex(b->g, v);
+        c = b->comp[v];
+        best_w = -1;
+        best_cost = 0.0;
+        // weights to earlier vertices are in their rows
+        for (w = 0; w < v; w++) {
+            if (b->comp[w] == c)
+                continue;
+            cost = get_edge_weight_value(get_edge_weight(vp, w));
+            if (best_w < 0 || cost < best_cost) {
+                best_w = w;
+                best_cost = cost;
+            }
+        }
+        // and the rest are this vertex's row, read sequentially
+        ewp = get_edge_weight(vp, v);
+        for (w = v + 1; w < b->num_vertices; w++) {
+            ewp++;
+            if (b->comp[w] == c)
+                continue;
+            cost = get_edge_weight_value(ewp);
+            if (best_w < 0 || cost < best_cost) {
+                best_w = w;
+                best_cost = cost;
+            }
+        }
+        b->nearest[v] = best_w;
+        b->nearest_cost[v] = best_cost;
+        if (best_w >= 0)
+            offer_edge(&b->best[c], 
+                       ((uint64_t) float_sort_key(best_cost) << 32) | v);
+    }
+}
+
+/*
+ * offer_edge
+ * atomically lower *best to candidate if candidate is smaller
+ */
+void offer_edge(uint64_t *best, uint64_t candidate) {
+    uint64_t current = __atomic_load_n(best, __ATOMIC_RELAXED);
+    while (candidate < current) {
+        if (__atomic_compare_exchange_n(best, &current, candidate, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return;
+    }
+}
+
+/*
+ * join_components
+ * end a round: join every component along its lightest edge out, unless
+ * an earlier component already joined the two along the same or an 
+ * equally light edge, and append the joining edges to the MST. This runs
+ * on one thread in component order, so ties always go the same way and 
+ * the MST edges do not depend on thread timing. It is O(|V|) a round, 
+ * against O(|V|^2) for finding the edges.
+ */
+void join_components(Boruvka *b) {
+    int c, v;
+    for (c = 0; c < b->num_vertices; c++) {
+        if (b->comp[c] != c || b->best[c] == NO_EDGE)
+            continue;
+        v = (int) (b->best[c] & 0xffffffffu);
+        // no other thread runs now, so the concurrent union is exact
+        if (uf_union_concurrent(b->uf, v, b->nearest[v]))
+            populate_edge(&b->x[b->num_mst_edges++], v, b->nearest[v], 
+                          b->nearest_cost[v]);
+    }
+}
+
+void task_vertices(Boruvka *b, int task, int *begin, int *end) {
+    *begin = task * VERTICES_PER_TASK;
+    *end = *begin + VERTICES_PER_TASK;
+    if (*end > b->num_vertices)
+        *end = b->num_vertices;
+}
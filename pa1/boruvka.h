@@ -0,0 +1,12 @@
+
+/*
+ * parallel_boruvka
+ * Given a pointer to a graph g with its weight matrix, determine an MST 
+ * with Boruvka's algorithm. Each round finds, in parallel over the 
+ * vertices, the lightest edge leaving every component and then joins the
+ * components along those edges with the concurrent union-find. At least
+ * half the components disappear per round, so there are O(log n) rounds
+ * of data parallel work on get_num_threads() threads.
+ * Returns an array of Edge structures with the |V| - 1 MST edges.
+ */
+Edge *parallel_boruvka(Graph *g);
@@ -111,6 +111,11 @@ Disjoint_Set *create_disjoint_set(int num_items) {
     return ds;
 }
 
+void destroy_disjoint_set(Disjoint_Set *ds) {
+    free(ds->items);
+    free(ds);
+}
+
 int get_num_sets(Disjoint_Set *ds) {
 	return ds->num_sets;
 }
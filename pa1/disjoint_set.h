@@ -14,6 +14,7 @@ struct ds_item {
 
 /* function prototypes */
 Disjoint_Set *create_disjoint_set(int num_items);
+void destroy_disjoint_set(Disjoint_Set *ds);
 int get_num_sets(Disjoint_Set *ds);
 
 void makeset(DSItem *x);
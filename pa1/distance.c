@@ -0,0 +1,207 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "distance.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_KERNELS
+#endif
+
+#define INLINE static inline __attribute__((always_inline))
+
+typedef void (*RowKernel)(float *coord, long stride, int dimension, float *p,
+                          int begin, int end, int squared, float *out);
+
+/*
+ * Every kernel body below takes the dimension as an argument and is always
+ * inlined. DISTANCE_KERNELS(name, d) instantiates the rows with d in place
+ * of it: for a constant d the compiler unrolls the axis loop and keeps p
+ * in registers, for d = dimension it gives the generic rows used for 
+ * every dimension without a specialization. On x86 these are the SSE and
+ * AVX2 rows, which finish their tails with scalar_row inlined; elsewhere
+ * they are scalar rows alone.
+ */
+#ifdef HAVE_X86_KERNELS
+#define DISTANCE_KERNELS(name, d) \
+    void distance_row_sse_##name(float *coord, long stride, \
+            int dimension, float *p, int begin, int end, int squared, \
+            float *out) { \
+        sse_row(coord, stride, d, p, begin, end, squared, out); \
+    } \
+    __attribute__((target("avx2"))) \
+    void distance_row_avx2_##name(float *coord, long stride, \
+            int dimension, float *p, int begin, int end, int squared, \
+            float *out) { \
+        avx2_row(coord, stride, d, p, begin, end, squared, out); \
+    }
+#define PICK_KERNEL(name) \
+    (avx2 ? distance_row_avx2_##name : distance_row_sse_##name)
+#else
+#define DISTANCE_KERNELS(name, d) \
+    void distance_row_scalar_##name(float *coord, long stride, \
+            int dimension, float *p, int begin, int end, int squared, \
+            float *out) { \
+        scalar_row(coord, stride, d, p, begin, end, squared, out); \
+    }
+#define PICK_KERNEL(name) distance_row_scalar_##name
+#endif
+
+/* internal function prototypes */
+RowKernel select_row_kernel(int dimension);
+
+/* function definitions */
+
+void distance_row(float *coord, long stride, int dimension, int i,
+                  int begin, int end, int squared, float *out) {
+    float p[MAX_DIMENSION];
+    int a;
+    if (dimension > MAX_DIMENSION)
+        error(1,"distance_row: dimension too large\n","");
+    for (a = 0; a < dimension; a++)
+        p[a] = coord[a * stride + i];
+    select_row_kernel(dimension)(coord, stride, dimension, p, begin, end,
+                                 squared, out);
+}
+
+/*
+ * scalar_row
+ * distances from point p to points [begin, end), one at a time; also 
+ * finishes the tails of the vector kernels
+ */
+INLINE void scalar_row(float *coord, long stride, int dimension, float *p,
+                       int begin, int end, int squared, float *out) {
+    float dist2, diff;
+    int j, a;
+    for (j = begin; j < end; j++) {
+        dist2 = 0.0;
+        for (a = 0; a < dimension; a++) {
+            diff = p[a] - coord[a * stride + j];
+            dist2 = dist2 + (diff * diff);
+        }
+        out[j - begin] = squared ? dist2 : sqrtf(dist2);
+    }
+}
+
+#ifdef HAVE_X86_KERNELS
+INLINE void sse_row(float *coord, long stride, int dimension, float *p,
+                    int begin, int end, int squared, float *out) {
+    __m128 dist2, diff;
+    int j = begin, a;
+    for (; j + 4 <= end; j += 4) {
+        dist2 = _mm_setzero_ps();
+        for (a = 0; a < dimension; a++) {
+            diff = _mm_sub_ps(_mm_set1_ps(p[a]), 
+                              _mm_loadu_ps(&coord[a * stride + j]));
+            dist2 = _mm_add_ps(dist2, _mm_mul_ps(diff, diff));
+        }
+        if (!squared)
+            dist2 = _mm_sqrt_ps(dist2);
+        _mm_storeu_ps(&out[j - begin], dist2);
+    }
+    scalar_row(coord, stride, dimension, p, j, end, squared, 
+               &out[j - begin]);
+}
+
+__attribute__((target("avx2")))
+INLINE void avx2_row(float *coord, long stride, int dimension, float *p,
+                     int begin, int end, int squared, float *out) {
+    __m256 dist2, diff;
+    int j = begin, a;
+    for (; j + 8 <= end; j += 8) {
+        dist2 = _mm256_setzero_ps();
+        for (a = 0; a < dimension; a++) {
+            diff = _mm256_sub_ps(_mm256_set1_ps(p[a]), 
+                                 _mm256_loadu_ps(&coord[a * stride + j]));
+            dist2 = _mm256_add_ps(dist2, _mm256_mul_ps(diff, diff));
+        }
+        if (!squared)
+            dist2 = _mm256_sqrt_ps(dist2);
+        _mm256_storeu_ps(&out[j - begin], dist2);
+    }
+    sse_row(coord, stride, dimension, p, j, end, squared, &out[j - begin]);
+}
+#endif
+
+DISTANCE_KERNELS(2, 2)
+DISTANCE_KERNELS(3, 3)
+DISTANCE_KERNELS(4, 4)
+DISTANCE_KERNELS(8, 8)
+DISTANCE_KERNELS(16, 16)
+DISTANCE_KERNELS(any, dimension)
+
+/*
+ * select_row_kernel
+ * The row kernel for dimension: AVX2 or SSE where the processor has them,
+ * scalar elsewhere, specialized if the dimension is one of the common ones.
+ */
+RowKernel select_row_kernel(int dimension) {
+#ifdef HAVE_X86_KERNELS
+    int avx2 = __builtin_cpu_supports("avx2");
+#endif
+    switch (dimension) {
+        case 2:
+            return PICK_KERNEL(2);
+        case 3:
+            return PICK_KERNEL(3);
+        case 4:
+            return PICK_KERNEL(4);
+        case 8:
+            return PICK_KERNEL(8);
+        case 16:
+            return PICK_KERNEL(16);
+        default:
+            return PICK_KERNEL(any);
+    }
+}
+
+/*
+ * point_sum2
+ * the squared distance between x and y, inlined into the point kernels 
+ * as the row kernels are
+ */
+INLINE float point_sum2(float *x, float *y, int dimension) {
+    float dist2 = 0.0, diff;
+    int a;
+    for (a = 0; a < dimension; a++) {
+        diff = x[a] - y[a];
+        dist2 = dist2 + (diff * diff);
+    }
+    return dist2;
+}
+
+#define POINT_KERNEL(name, d) \
+    float point_distance2_##name(float *x, float *y, int dimension) { \
+        return point_sum2(x, y, d); \
+    }
+
+POINT_KERNEL(2, 2)
+POINT_KERNEL(3, 3)
+POINT_KERNEL(4, 4)
+POINT_KERNEL(8, 8)
+POINT_KERNEL(16, 16)
+POINT_KERNEL(any, dimension)
+
+PointKernel select_point_kernel(int dimension) {
+    switch (dimension) {
+        case 2:
+            return point_distance2_2;
+        case 3:
+            return point_distance2_3;
+        case 4:
+            return point_distance2_4;
+        case 8:
+            return point_distance2_8;
+        case 16:
+            return point_distance2_16;
+        default:
+            return point_distance2_any;
+    }
+}
+
+float point_distance2(float *x, float *y, int dimension) {
+    return select_point_kernel(dimension)(x, y, dimension);
+}
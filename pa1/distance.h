@@ -0,0 +1,28 @@
+typedef float (*PointKernel)(float *x, float *y, int dimension);
+
+/*
+ * distance_row
+ * Set out[j - begin] to the euclidean distance between points i and j for 
+ * every j in [begin, end), or to its square if squared is 1. coord holds 
+ * dimension axis arrays, stride floats apart (see graph.h). Eight or four
+ * distances are computed at a time with AVX2 or SSE where the processor 
+ * has them, with a scalar fallback elsewhere; every path gives the same 
+ * bits as sqrtf(point_distance2). Dimensions 2, 3, 4, 8 and 16 have kernels 
+ * of their own, any other up to MAX_DIMENSION takes the generic one.
+ */
+void distance_row(float *coord, long stride, int dimension, int i,
+                  int begin, int end, int squared, float *out);
+
+/*
+ * point_distance2
+ * returns: the squared euclidean distance between the points x and y, 
+ * dimension floats each, summed in the same order as distance_row
+ */
+float point_distance2(float *x, float *y, int dimension);
+
+/*
+ * select_point_kernel
+ * returns: point_distance2 specialized for dimension, for loops that 
+ * measure many pairs and should pick the kernel once
+ */
+PointKernel select_point_kernel(int dimension);
@@ -0,0 +1,229 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "union_find.h"
+#include "kruskal.h"
+#include "kdtree.h"
+#include "emst.h"
+#include "distance.h"
+
+#define KD_LEAF_SIZE 16
+
+typedef struct dual_tree_boruvka DualTreeBoruvka;
+
+/* internal structures */
+
+/*
+ * state of a dual-tree Boruvka run. Components are identified by the tree
+ * position of their union-find root.
+ */
+struct dual_tree_boruvka {
+    KDTree *t;
+    UnionFind *uf;
+    int *comp;          // component of each point
+    int *node_comp;     // component shared by all points of a node, or -1
+    float *node_bound;  // no point of a node has a closer candidate beyond this
+    float *best_dist2;  // shortest edge out of each component found so far
+    int *best_from;     // its endpoints, as tree positions
+    int *best_to;
+};
+
+/* internal function prototypes */
+DualTreeBoruvka *create_dual_tree_boruvka(Graph *g);
+void destroy_dual_tree_boruvka(DualTreeBoruvka *s);
+void label_components(DualTreeBoruvka *s);
+void find_component_neighbors(DualTreeBoruvka *s, int qi, int ri);
+void compare_kd_leaves(DualTreeBoruvka *s, int qi, int ri);
+int add_component_edges(DualTreeBoruvka *s, Edge *x, int num_edges);
+
+/* function definitions */
+
+Edge *kdtree_boruvka(Graph *g) {
+    int num_vertices = get_num_vertices(g);
+    int mst_size = num_vertices - 1;
+    Edge *x = create_edge_array(mst_size);
+    if (num_vertices < 2)
+        return x;
+    if (get_dimension(get_vertex(g, 0)) < 2)
+        error(1,"kdtree_boruvka: graph needs dimension 2 or more\n","");
+
+    DualTreeBoruvka *s = create_dual_tree_boruvka(g);
+    int num_edges = 0;
+    while (num_edges < mst_size) {
+        label_components(s);
+        find_component_neighbors(s, 0, 0);
+        num_edges = add_component_edges(s, x, num_edges);
+    }
+
+    destroy_dual_tree_boruvka(s);
+    return x;
+}
+
+/*
+ * label_components
+ * Start a Boruvka round: record the component of every point and of every
+ * node whose points all share one, and forget last round's candidates.
+ */
+void label_components(DualTreeBoruvka *s) {
+    KDTree *t = s->t;
+    KDNode *node;
+    int i, pos, c;
+    for (pos = 0; pos < t->num_points; pos++) {
+        s->comp[pos] = uf_find(s->uf, pos);
+        s->best_dist2[pos] = INFINITY;
+    }
+
+    // children come after their parent, so walk the nodes backwards
+    for (i = t->num_nodes - 1; i >= 0; i--) {
+        node = get_kd_node(t, i);
+        s->node_bound[i] = INFINITY;
+        if (is_kd_leaf(node)) {
+            c = s->comp[node->begin];
+            for (pos = node->begin + 1; pos < node->end && c >= 0; pos++) {
+                if (s->comp[pos] != c)
+                    c = -1;
+            }
+        } else {
+            c = s->node_comp[node->left];
+            if (c != s->node_comp[node->right])
+                c = -1;
+        }
+        s->node_comp[i] = c;
+    }
+}
+
+/*
+ * find_component_neighbors
+ * For every point of query node qi, look for a shorter edge out of its 
+ * component among the points of reference node ri. Pairs of nodes that 
+ * lie in one component, or that are too far apart to improve on any
+ * candidate of qi, are skipped.
+ */
+void find_component_neighbors(DualTreeBoruvka *s, int qi, int ri) {
+    KDTree *t = s->t;
+    KDNode *q = get_kd_node(t, qi), *r = get_kd_node(t, ri);
+    if (s->node_comp[qi] >= 0 && s->node_comp[qi] == s->node_comp[ri])
+        return;
+    if (kd_node_min_dist2(t, q, r) > s->node_bound[qi])
+        return;
+
+    if (is_kd_leaf(q) && is_kd_leaf(r)) {
+        compare_kd_leaves(s, qi, ri);
+        return;
+    }
+
+    int near, far, qc[2], k, num_qc;
+    if (is_kd_leaf(q)) {
+        qc[0] = qi;
+        num_qc = 1;
+    } else {
+        qc[0] = q->left;
+        qc[1] = q->right;
+        num_qc = 2;
+    }
+    for (k = 0; k < num_qc; k++) {
+        if (is_kd_leaf(r)) {
+            find_component_neighbors(s, qc[k], ri);
+            continue;
+        }
+        // visit the closer reference child first to tighten the bound
+        near = r->left;
+        far = r->right;
+        if (kd_node_min_dist2(t, get_kd_node(t, qc[k]), get_kd_node(t, far)) <
+            kd_node_min_dist2(t, get_kd_node(t, qc[k]), get_kd_node(t, near))) {
+            near = r->right;
+            far = r->left;
+        }
+        find_component_neighbors(s, qc[k], near);
+        find_component_neighbors(s, qc[k], far);
+    }
+
+    if (!is_kd_leaf(q)) {
+        float lb = s->node_bound[q->left], rb = s->node_bound[q->right];
+        s->node_bound[qi] = (lb > rb) ? lb : rb;
+    }
+}
+
+void compare_kd_leaves(DualTreeBoruvka *s, int qi, int ri) {
+    KDTree *t = s->t;
+    KDNode *q = get_kd_node(t, qi), *r = get_kd_node(t, ri);
+    int dim = t->dimension, qp, rp, c;
+    float d2, bound = 0.0;
+    for (qp = q->begin; qp < q->end; qp++) {
+        c = s->comp[qp];
+        for (rp = r->begin; rp < r->end; rp++) {
+            if (s->comp[rp] == c)
+                continue;
+            d2 = kd_point_dist2(get_kd_point(t, qp), get_kd_point(t, rp), dim);
+            if (d2 < s->best_dist2[c]) {
+                s->best_dist2[c] = d2;
+                s->best_from[c] = qp;
+                s->best_to[c] = rp;
+            }
+        }
+        if (s->best_dist2[c] > bound)
+            bound = s->best_dist2[c];
+    }
+    s->node_bound[qi] = bound;
+}
+
+/*
+ * add_component_edges
+ * End a Boruvka round: join every component with its nearest neighbor
+ * component and append each joining edge to x.
+ * Returns: the number of edges now in x.
+ */
+int add_component_edges(DualTreeBoruvka *s, Edge *x, int num_edges) {
+    KDTree *t = s->t;
+    int pos, from, to;
+    for (pos = 0; pos < t->num_points; pos++) {
+        if (s->comp[pos] != pos || s->best_dist2[pos] == INFINITY)
+            continue;
+        from = s->best_from[pos];
+        to = s->best_to[pos];
+        if (!uf_union(s->uf, from, to))
+            continue; // the other component already chose this edge
+        populate_edge(&x[num_edges], t->index[from], t->index[to],
+                      sqrtf(point_distance2(get_kd_point(t, from),
+                                            get_kd_point(t, to),
+                                            t->dimension)));
+        num_edges++;
+    }
+    return num_edges;
+}
+
+DualTreeBoruvka *create_dual_tree_boruvka(Graph *g) {
+    DualTreeBoruvka *s = malloc(sizeof(DualTreeBoruvka));
+    if (s == NULL)
+        error(1,"create_dual_tree_boruvka: cannot malloc state\n","");
+
+    int n = get_num_vertices(g);
+    s->t = create_kd_tree(g, KD_LEAF_SIZE);
+    s->uf = create_union_find(n);
+
+    s->comp = malloc(n * sizeof(int));
+    s->best_dist2 = create_float_array(n);
+    s->best_from = malloc(n * sizeof(int));
+    s->best_to = malloc(n * sizeof(int));
+    s->node_comp = malloc(s->t->num_nodes * sizeof(int));
+    s->node_bound = create_float_array(s->t->num_nodes);
+    if (s->comp == NULL || s->best_dist2 == NULL || s->best_from == NULL ||
+        s->best_to == NULL || s->node_comp == NULL || s->node_bound == NULL)
+        error(1,"create_dual_tree_boruvka: cannot malloc arrays\n","");
+    return s;
+}
+
+void destroy_dual_tree_boruvka(DualTreeBoruvka *s) {
+    destroy_kd_tree(s->t);
+    destroy_union_find(s->uf);
+    free(s->comp);
+    free(s->node_comp);
+    free(s->node_bound);
+    free(s->best_dist2);
+    free(s->best_from);
+    free(s->best_to);
+    free(s);
+}
@@ -0,0 +1,10 @@
+
+/*
+ * kdtree_boruvka
+ * Given a pointer to a graph g of dimension 2 or more that holds only 
+ * vertex coordinates, determine the exact euclidean MST with dual-tree 
+ * Boruvka over a k-d tree of the points (March, Ram and Gray, 2010). 
+ * No edge weight matrix is built; the run time is close to O(n log n).
+ * Returns an array of Edge structures with the |V| - 1 MST edges.
+ */
+Edge *kdtree_boruvka(Graph *g);
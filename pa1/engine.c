@@ -0,0 +1,281 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "random_graph.h"
+#include "kruskal.h"
+#include "filter_kruskal.h"
+#include "boruvka.h"
+#include "prim.h"
+#include "emst.h"
+#include "sparse_interval.h"
+#include "sparse_graph.h"
+#include "external_kruskal.h"
+#include "graph_file.h"
+#include "engine.h"
+
+/* engine names as given on the randmst command line, indexed by Engine */
+static char *engine_names[] = {
+    "kruskal",
+    "pruned",
+    "filter",
+    "boruvka",
+    "prim",
+    "kdtree",
+    "sparse",
+    "lazy",
+    "csr",
+    "external",
+    "auto"
+};
+
+#define NUM_ENGINES (sizeof(engine_names) / sizeof(engine_names[0]))
+
+/* 1 if the weight matrix engines should store squared distances */
+static int squared_distances = 0;
+
+/* edges the lazy engine popped and edges it had, summed over all trials */
+static long edges_examined = 0;
+static long edges_listed = 0;
+
+Engine parse_engine(char *name) {
+    unsigned int i;
+    for (i = 0; i < NUM_ENGINES; i++) {
+        if (strcmp(name, engine_names[i]) == 0)
+            return (Engine) i;
+    }
+    error(2,"parse_engine: unknown engine - try kruskal, pruned, filter, "
+          "boruvka, prim, kdtree, sparse, lazy, csr, external, auto\n","");
+    return ENGINE_KRUSKAL;
+}
+
+char *get_engine_name(Engine e) {
+    return engine_names[e];
+}
+
+/*
+ * set_squared_distances
+ * make the engines that build a weight matrix (kruskal, pruned, filter, 
+ * boruvka) store squared distances for dimensions 2 and up. The MST is the
+ * same; only its n - 1 edges get a square root.
+ */
+void set_squared_distances(int squared) {
+    squared_distances = squared;
+}
+
+int get_squared_distances(void) {
+    return squared_distances;
+}
+
+/*
+ * get_edges_examined
+ * the number of edges the lazy engine examined and the number it could 
+ * have, over every trial run so far
+ */
+void get_edges_examined(long *num_examined, long *num_edges) {
+    *num_examined = __atomic_load_n(&edges_examined, __ATOMIC_RELAXED);
+    *num_edges = __atomic_load_n(&edges_listed, __ATOMIC_RELAXED);
+}
+
+/*
+ * create_matrix_graph
+ * the random graph with weight matrix the matrix engines run on, squared 
+ * if set_squared_distances asked for it
+ */
+Graph *create_matrix_graph(int dim, int num_vertices) {
+    if (squared_distances)
+        return create_random_squared_graph(dim, num_vertices);
+    return create_random_graph(dim, num_vertices);
+}
+
+/*
+ * solves_matrix_graph
+ * whether engine e in dimension dim solves the graph create_matrix_graph 
+ * makes from the same random stream. Dimension 0 prim and sparse draw 
+ * their weights in their own order while solving, so they do not.
+ */
+int solves_matrix_graph(Engine e, int dim) {
+    return dim != 0 || (e != ENGINE_PRIM && e != ENGINE_SPARSE);
+}
+
+EdgeWeight random_mst_weight(Engine e, int dim, int num_vertices) {
+    return engine_mst_weight(e, create_engine_graph(e, dim, num_vertices));
+}
+
+Graph *create_engine_graph(Engine e, int dim, int num_vertices) {
+    Graph *g;
+    switch (e) {
+        case ENGINE_PRIM:
+            g = create_random_point_graph(dim, num_vertices);
+            break;
+        case ENGINE_KDTREE:
+            if (dim == 0)
+                error(2,"random_mst_weight: kdtree needs dimension 2 or more\n","");
+            g = create_random_point_graph(dim, num_vertices);
+            break;
+        case ENGINE_SPARSE:
+            if (dim != 0)
+                error(2,"random_mst_weight: sparse needs dimension 0\n","");
+            g = create_random_point_graph(dim, num_vertices);
+            break;
+        case ENGINE_EXTERNAL:
+            g = create_random_point_graph(dim, num_vertices);
+            set_squared_weights(g, squared_distances && dim != 0);
+            break;
+        default:
+            g = create_matrix_graph(dim, num_vertices);
+            break;
+    }
+    return g;
+}
+
+EdgeWeight engine_mst_weight(Engine e, Graph *g) {
+    Edge *mst;
+    long num_examined, num_edges;
+    switch (e) {
+        case ENGINE_PRUNED:
+            mst = pruned_kruskal(g);
+            break;
+        case ENGINE_FILTER:
+            mst = filter_kruskal(g);
+            break;
+        case ENGINE_BORUVKA:
+            mst = parallel_boruvka(g);
+            break;
+        case ENGINE_PRIM:
+            mst = prim(g);
+            break;
+        case ENGINE_KDTREE:
+            mst = kdtree_boruvka(g);
+            break;
+        case ENGINE_SPARSE:
+            mst = sparse_interval_mst(get_num_vertices(g));
+            break;
+        case ENGINE_LAZY:
+            mst = lazy_kruskal(g, &num_examined, &num_edges);
+            // trials may run on several threads at once
+            __atomic_fetch_add(&edges_examined, num_examined, 
+                               __ATOMIC_RELAXED);
+            __atomic_fetch_add(&edges_listed, num_edges, __ATOMIC_RELAXED);
+            break;
+        case ENGINE_CSR:
+            mst = pruned_sparse_prim(g);
+            break;
+        case ENGINE_EXTERNAL:
+            mst = external_kruskal(g);
+            break;
+        case ENGINE_KRUSKAL:
+        case ENGINE_AUTO:       // unplanned: the reference path
+        default:
+            mst = kruskal(g);
+            break;
+    }
+
+    EdgeWeight weight = compute_mst_weight(g, mst);
+    destroy_edge_array(mst);
+    destroy_graph(g);
+    return weight;
+}
+
+/*
+ * graph_file_mst_weight
+ * The edge list engines (kruskal, lazy, filter) run on the edges of the 
+ * file as mapped, and boruvka and csr on a sparse graph of them. prim and
+ * kdtree treat a file with coordinates as the complete euclidean graph on
+ * those points; prim without coordinates uses the sparse graph too.
+ */
+EdgeWeight graph_file_mst_weight(Engine e, GraphFile *gf) {
+    int n = get_graph_file_num_vertices(gf);
+    int dim = get_graph_file_dimension(gf);
+    Graph *g = create_graph(n);
+    if (dim > 0) {
+        create_coordinates(g, dim);
+        memcpy(g->coord, get_graph_file_coordinates(gf), 
+               (size_t) dim * n * sizeof(float));
+    }
+
+    Edge *mst;
+    int num_mst_edges = n - 1;
+    if (e == ENGINE_AUTO)
+        e = ENGINE_KRUSKAL;     // files are solved on the reference path
+    switch (e) {
+        case ENGINE_KRUSKAL:
+        case ENGINE_LAZY:
+        case ENGINE_FILTER:
+            set_squared_weights(g, has_graph_file_squared_weights(gf));
+            mst = create_edge_array(n - 1);
+            if (e == ENGINE_KRUSKAL)
+                num_mst_edges = kruskal_edge_list(n, 
+                                    get_graph_file_edges(gf), mst);
+            else if (e == ENGINE_LAZY)
+                num_mst_edges = lazy_kruskal_edge_list(n, 
+                                    get_graph_file_edges(gf), mst, NULL);
+            else
+                num_mst_edges = filter_kruskal_edge_list(n, 
+                                    get_graph_file_edges(gf), mst);
+            break;
+        case ENGINE_PRIM:
+        case ENGINE_BORUVKA:
+        case ENGINE_CSR:
+            if (dim < 2 || e != ENGINE_PRIM) {
+                // Prim or Boruvka on the edges, held in O(|V| + |E|)
+                set_squared_weights(g, has_graph_file_squared_weights(gf));
+                SparseGraph *sg = create_sparse_graph(n, 
+                                    get_edges(get_graph_file_edges(gf)),
+                                    get_num_edges(get_graph_file_edges(gf)));
+                mst = create_edge_array(n - 1);
+                if (e == ENGINE_BORUVKA)
+                    num_mst_edges = sparse_boruvka(sg, mst);
+                else
+                    num_mst_edges = sparse_prim(sg, mst);
+                destroy_sparse_graph(sg);
+            } else {
+                mst = prim(g);
+            }
+            break;
+        case ENGINE_KDTREE:
+            if (dim < 2)
+                error(2,"graph_file_mst_weight: kdtree needs coordinates\n",
+                      "");
+            mst = kdtree_boruvka(g);
+            break;
+        default:
+            error(2,"graph_file_mst_weight: engine needs a generated graph "
+                  "- try kruskal, lazy, filter, boruvka, prim, csr, "
+                  "kdtree\n","");
+            return 0.0;
+    }
+    if (num_mst_edges != n - 1)
+        error(2,"graph_file_mst_weight: graph is not connected\n","");
+
+    EdgeWeight weight = compute_mst_weight(g, mst);
+    destroy_edge_array(mst);
+    destroy_graph(g);
+    return weight;
+}
+
+EdgeWeight compute_mst_weight(Graph *g, Edge *mst) {
+    int i;
+    // testing only:
+    //EdgeWeight max = 0.0; 
+    EdgeWeight tot_weight = 0.0;
+    int squared = has_squared_weights(g);
+    for (i = 0; i < get_num_vertices(g) - 1; i++) {
+        //testing only
+        //if (get_cost(&mst[i]) > max)
+        //    max = get_cost(&mst[i]);
+
+        // the one square root each MST edge needs
+        if (squared)
+            tot_weight += sqrtf(get_cost(&mst[i]));
+        else
+            tot_weight += get_cost(&mst[i]);
+    }
+    // testing only:
+    //printf("dim: %d num vertices: %d max weight: %f\n",
+    //    get_dimension(get_vertex(g,0)), get_num_vertices(g), max);
+    return tot_weight;
+}
@@ -0,0 +1,52 @@
+
+typedef enum engine Engine;
+
+/* the MST algorithms randmst can run a trial with */
+enum engine {
+    ENGINE_KRUSKAL,     // full weight matrix, full edge list, Kruskal
+    ENGINE_PRUNED,      // full weight matrix, edges below k(n, d), Kruskal
+    ENGINE_FILTER,      // full weight matrix, parallel Filter-Kruskal
+    ENGINE_BORUVKA,     // full weight matrix, parallel Boruvka
+    ENGINE_PRIM,        // coordinates only, O(n^2) time O(n) memory Prim
+    ENGINE_KDTREE,      // coordinates only, k-d tree dual-tree Boruvka
+    ENGINE_SPARSE,      // dimension 0 only, samples just the light edges
+    ENGINE_LAZY,        // full weight matrix, edge heap popped until done
+    ENGINE_CSR,         // full weight matrix, edges below k(n, d) as CSR, Prim
+    ENGINE_EXTERNAL,    // coordinates only, sorted runs on disk, Kruskal
+    ENGINE_AUTO         // let plan_engine pick one of the above
+};
+
+Engine parse_engine(char *name);
+char *get_engine_name(Engine e);
+void set_squared_distances(int squared);
+int get_squared_distances(void);
+Graph *create_matrix_graph(int dim, int num_vertices);
+int solves_matrix_graph(Engine e, int dim);
+void get_edges_examined(long *num_examined, long *num_edges);
+
+/*
+ * random_mst_weight
+ * Generate one random graph of num_vertices vertices in dimension dim in 
+ * the form engine e needs, solve it with e and return the MST weight.
+ */
+EdgeWeight random_mst_weight(Engine e, int dim, int num_vertices);
+
+/*
+ * create_engine_graph, engine_mst_weight
+ * The two halves of random_mst_weight: generate the graph engine e needs
+ * from the calling thread's random stream, and solve it with e, which 
+ * also destroys it. Batch runs do them on different threads; the engines
+ * that draw weights while solving (dimension 0 prim, sparse and external)
+ * draw nothing while generating, so the solving thread only has to start
+ * the same stream.
+ */
+Graph *create_engine_graph(Engine e, int dim, int num_vertices);
+EdgeWeight engine_mst_weight(Engine e, Graph *g);
+
+/*
+ * graph_file_mst_weight
+ * Solve the graph in a mapped graph file with engine e and return the MST 
+ * weight. The graph must be connected.
+ */
+EdgeWeight graph_file_mst_weight(Engine e, GraphFile *gf);
+EdgeWeight compute_mst_weight(Graph *g, Edge *mst);
@@ -0,0 +1,389 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "radix_sort.h"
+#include "union_find.h"
+#include "distance.h"
+#include "external_kruskal.h"
+
+#define DEFAULT_RUN_EDGES (1L << 22)    // 48 MB of edges per run
+#define MIN_READ_EDGES 1024             // per run buffer during the merge
+#define MAX_MERGE_RUNS 64               // runs merged at once
+#define DEFAULT_RUN_DIR "/var/tmp"      // /tmp is often RAM (tmpfs)
+
+typedef struct run Run;
+typedef struct run_set RunSet;
+typedef struct merge Merge;
+
+/* internal structures */
+
+/* one sorted run in a spill file and the window being merged from it */
+struct run {
+    long offset;            // edges before the run's unread ones in the file
+    long remaining;         // edges not yet read into buf
+    Edge *buf;
+    long buf_size;
+    long buf_pos;           // next edge of buf to merge
+};
+
+/* sorted runs stored one after another in a single unlinked spill file */
+struct run_set {
+    int fd;                 // -1 until the first run is written
+    long num_edges;         // edges in the file
+    Run *runs;
+    int num_runs;
+    int capacity;
+};
+
+/* a k-way merge of some runs of a set, through a heap of their windows */
+struct merge {
+    int fd;
+    Run **heap;
+    int size;
+};
+
+static long run_edges = DEFAULT_RUN_EDGES;
+static char *run_dir = NULL;
+
+/* internal function prototypes */
+void open_run_set(RunSet *rs);
+void write_run(RunSet *rs, Edge *edges, long num_edges);
+void add_run(RunSet *rs);
+void append_edges(RunSet *rs, Edge *edges, long num_edges);
+void merge_pass(RunSet *rs, long memory_edges);
+int merge_runs(RunSet *rs, int num_vertices, Edge *x, long read_edges);
+void start_merge(Merge *m, RunSet *rs, int first, int count, 
+                 long read_edges);
+int pop_merged_edge(Merge *m, Edge *e);
+void end_merge(Merge *m);
+int refill_run(int fd, Run *r);
+Edge *create_run_buffer(long num_edges);
+void sift_down_run(Run **heap, int size, int i);
+void destroy_run_set(RunSet *rs);
+
+/* function definitions */
+
+void set_external_run_edges(long edges) {
+    run_edges = (edges < MIN_READ_EDGES) ? MIN_READ_EDGES : edges;
+}
+
+long get_external_run_edges(void) {
+    return run_edges;
+}
+
+void set_external_run_dir(char *dir) {
+    run_dir = dir;
+}
+
+char *get_external_run_dir(void) {
+    char *tmpdir = getenv("TMPDIR");
+    if (run_dir != NULL)
+        return run_dir;
+    if (tmpdir != NULL && tmpdir[0] != '\0')
+        return tmpdir;
+    return DEFAULT_RUN_DIR;
+}
+
+Edge *external_kruskal(Graph *g) {
+    int n = get_num_vertices(g), dim = g->dimension, i, j;
+    int squared = has_squared_weights(g);
+    Edge *x = create_edge_array(n - 1);
+    if (n < 2)
+        return x;
+
+    long chunk_size = run_edges, count = 0;
+    Edge *chunk = create_edge_array(chunk_size);
+    EdgeWeight *row = create_edge_weights(n);
+    RunSet rs = {-1, 0, NULL, 0, 0};
+
+    for (i = 0; i < n - 1; i++) {
+        if (dim > 0)
+            distance_row(g->coord, n, dim, i, i + 1, n, squared, row);
+        for (j = i + 1; j < n; j++) {
+            populate_edge(&chunk[count], i, j, 
+                          (dim > 0) ? row[j - i - 1] : random_float(0,1));
+            if (++count == chunk_size) {
+                write_run(&rs, chunk, count);
+                count = 0;
+            }
+        }
+    }
+    free(row);
+
+    if (rs.num_runs == 0) {
+        // it all fit in one chunk: no disk needed
+        EdgeList el = {chunk, count};
+        kruskal_edge_list(n, &el, x);
+        destroy_edge_array(chunk);
+        return x;
+    }
+    if (count > 0)
+        write_run(&rs, chunk, count);
+    destroy_edge_array(chunk);
+
+    // the merge buffers together take about as much memory as one chunk
+    while (rs.num_runs > MAX_MERGE_RUNS)
+        merge_pass(&rs, chunk_size);
+    long read_edges = chunk_size / rs.num_runs;
+    if (read_edges < MIN_READ_EDGES)
+        read_edges = MIN_READ_EDGES;
+    merge_runs(&rs, n, x, read_edges);
+    destroy_run_set(&rs);
+    return x;
+}
+
+/*
+ * open_run_set
+ * Create the spill file of rs in the run directory and unlink it at 
+ * once, so the system deletes it when it is closed, even after a crash.
+ */
+void open_run_set(RunSet *rs) {
+    char *dir = get_external_run_dir();
+    char *path = malloc(strlen(dir) + 32);
+    if (path == NULL)
+        error(1,"open_run_set: cannot malloc path\n","");
+    sprintf(path, "%s/randmst-runs.XXXXXX", dir);
+    rs->fd = mkstemp(path);
+    if (rs->fd < 0)
+        error(1,dir,"- open_run_set: cannot create a spill file\n");
+    unlink(path);
+    free(path);
+    rs->num_edges = 0;
+    rs->runs = NULL;
+    rs->num_runs = 0;
+    rs->capacity = 0;
+}
+
+/*
+ * write_run
+ * Sort num_edges edges and append them to rs as a new run.
+ */
+void write_run(RunSet *rs, Edge *edges, long num_edges) {
+    radix_sort_edges(edges, num_edges);
+    add_run(rs);
+    append_edges(rs, edges, num_edges);
+}
+
+/*
+ * add_run
+ * Start a new, empty run at the end of the spill file of rs.
+ */
+void add_run(RunSet *rs) {
+    if (rs->fd < 0)
+        open_run_set(rs);
+    if (rs->num_runs == rs->capacity) {
+        rs->capacity = (rs->capacity > 0) ? 2 * rs->capacity : 16;
+        rs->runs = realloc(rs->runs, rs->capacity * sizeof(Run));
+        if (rs->runs == NULL)
+            error(1,"add_run: cannot realloc runs\n","");
+    }
+    Run *r = &rs->runs[rs->num_runs++];
+    r->offset = rs->num_edges;
+    r->remaining = 0;
+    r->buf = NULL;
+    r->buf_size = 0;
+    r->buf_pos = 0;
+}
+
+/*
+ * append_edges
+ * Write num_edges edges to the end of the spill file of rs, as the next 
+ * edges of its last run.
+ */
+void append_edges(RunSet *rs, Edge *edges, long num_edges) {
+    char *p = (char *) edges;
+    size_t left = num_edges * sizeof(Edge);
+    off_t at = rs->num_edges * (off_t) sizeof(Edge);
+    ssize_t written;
+    while (left > 0) {
+        written = pwrite(rs->fd, p, left, at);
+        if (written <= 0)
+            error(1,"append_edges: cannot write run - out of disk "
+                  "space?\n","");
+        p += written;
+        at += written;
+        left -= written;
+    }
+    rs->num_edges += num_edges;
+    rs->runs[rs->num_runs - 1].remaining += num_edges;
+}
+
+/*
+ * merge_pass
+ * Merge the runs of rs MAX_MERGE_RUNS at a time into the runs of a new 
+ * spill file, which then replaces the old one. Each pass divides the 
+ * number of runs by MAX_MERGE_RUNS, and no more than two spill files are
+ * ever open. The read and write buffers share memory_edges edges.
+ */
+void merge_pass(RunSet *rs, long memory_edges) {
+    RunSet next = {-1, 0, NULL, 0, 0};
+    long buf_edges = memory_edges / (MAX_MERGE_RUNS + 1);
+    if (buf_edges < MIN_READ_EDGES)
+        buf_edges = MIN_READ_EDGES;
+    Edge *out = create_run_buffer(buf_edges);
+    long out_size;
+    int first, count;
+    Merge m;
+    for (first = 0; first < rs->num_runs; first += count) {
+        count = rs->num_runs - first;
+        if (count > MAX_MERGE_RUNS)
+            count = MAX_MERGE_RUNS;
+        start_merge(&m, rs, first, count, buf_edges);
+        add_run(&next);
+        out_size = 0;
+        while (pop_merged_edge(&m, &out[out_size])) {
+            if (++out_size == buf_edges) {
+                append_edges(&next, out, out_size);
+                out_size = 0;
+            }
+        }
+        if (out_size > 0)
+            append_edges(&next, out, out_size);
+        end_merge(&m);
+    }
+    free(out);
+    destroy_run_set(rs);
+    *rs = next;
+}
+
+/*
+ * merge_runs
+ * Merge the runs lightest edge first, feeding each edge to the 
+ * union-find until it is connected.
+ * Returns the number of tree edges written to x.
+ */
+int merge_runs(RunSet *rs, int num_vertices, Edge *x, long read_edges) {
+    Merge m;
+    Edge e;
+    int j = 0;
+    start_merge(&m, rs, 0, rs->num_runs, read_edges);
+    UnionFind *uf = create_union_find(num_vertices);
+    while (get_num_components(uf) > 1 && pop_merged_edge(&m, &e)) {
+        if (uf_union(uf, get_start_index(&e), get_end_index(&e)))
+            x[j++] = e;
+    }
+    destroy_union_find(uf);
+    end_merge(&m);
+    return j;
+}
+
+/*
+ * start_merge
+ * Give runs first .. first + count - 1 of rs read buffers of read_edges
+ * edges and heap them by their lightest unmerged edge.
+ */
+void start_merge(Merge *m, RunSet *rs, int first, int count, 
+                 long read_edges) {
+    m->fd = rs->fd;
+    m->heap = malloc(count * sizeof(Run *));
+    if (m->heap == NULL)
+        error(1,"start_merge: cannot malloc heap\n","");
+    m->size = 0;
+    int k;
+    for (k = first; k < first + count; k++) {
+        Run *r = &rs->runs[k];
+        r->buf = create_run_buffer(read_edges);
+        r->buf_size = read_edges;
+        if (refill_run(m->fd, r))
+            m->heap[m->size++] = r;
+        else
+            free(r->buf);
+    }
+    for (k = m->size / 2 - 1; k >= 0; k--)
+        sift_down_run(m->heap, m->size, k);
+}
+
+/*
+ * pop_merged_edge
+ * Take the lightest edge left in the merge into *e.
+ * Returns 0 once every run is used up.
+ */
+int pop_merged_edge(Merge *m, Edge *e) {
+    if (m->size == 0)
+        return 0;
+    Run *r = m->heap[0];
+    *e = r->buf[r->buf_pos];
+    if (++r->buf_pos == r->buf_size && !refill_run(m->fd, r)) {
+        free(r->buf);
+        m->heap[0] = m->heap[--m->size];   // this run is used up
+    }
+    sift_down_run(m->heap, m->size, 0);
+    return 1;
+}
+
+void end_merge(Merge *m) {
+    int k;
+    for (k = 0; k < m->size; k++)
+        free(m->heap[k]->buf);
+    free(m->heap);
+}
+
+/*
+ * refill_run
+ * Read the next window of r from the spill file fd into its buffer.
+ * Returns 0 if r has no edges left.
+ */
+int refill_run(int fd, Run *r) {
+    long want = (r->remaining < r->buf_size) ? r->remaining : r->buf_size;
+    if (want == 0)
+        return 0;
+    char *p = (char *) r->buf;
+    size_t left = want * sizeof(Edge);
+    off_t at = r->offset * (off_t) sizeof(Edge);
+    ssize_t got;
+    while (left > 0) {
+        got = pread(fd, p, left, at);
+        if (got <= 0)
+            error(1,"refill_run: cannot read run\n","");
+        p += got;
+        at += got;
+        left -= got;
+    }
+    r->offset += want;
+    r->remaining -= want;
+    r->buf_size = want;
+    r->buf_pos = 0;
+    return 1;
+}
+
+/*
+ * create_run_buffer
+ * Merge buffers come from the heap, not the trial arena: passes free and
+ * reallocate them, which the arena would only take back at the next reset.
+ */
+Edge *create_run_buffer(long num_edges) {
+    Edge *buf = malloc(num_edges * sizeof(Edge));
+    if (buf == NULL)
+        error(1,"create_run_buffer: cannot malloc merge buffer\n","");
+    return buf;
+}
+
+void sift_down_run(Run **heap, int size, int i) {
+    if (size == 0)
+        return;
+    Run *r = heap[i];
+    int child;
+    while ((child = 2 * i + 1) < size) {
+        if (child + 1 < size && 
+            get_cost(&heap[child + 1]->buf[heap[child + 1]->buf_pos]) < 
+            get_cost(&heap[child]->buf[heap[child]->buf_pos]))
+            child++;
+        if (get_cost(&heap[child]->buf[heap[child]->buf_pos]) >= 
+            get_cost(&r->buf[r->buf_pos]))
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = r;
+}
+
+void destroy_run_set(RunSet *rs) {
+    if (rs->fd >= 0)
+        close(rs->fd);
+    free(rs->runs);
+}
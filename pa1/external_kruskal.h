@@ -0,0 +1,31 @@
+/*
+ * external_kruskal
+ * Given a pointer to a graph g that holds only vertex coordinates (no edge
+ * weight matrix) determine an MST with Kruskal's algorithm out of core. 
+ * The edges are generated in chunks of get_external_run_edges() edges, 
+ * each chunk is radix sorted and appended to a spill file in the run 
+ * directory as a run. Merge passes combine up to 64 runs at a time until
+ * at most 64 are left, and those are k-way merged into a streaming 
+ * union-find pass that stops at |V| - 1 tree edges. Memory is 
+ * O(chunk + |V|), disk O(|E|) and at most two files are open, so complete
+ * graphs with billions of edges fit. For dimension 0
+ * each weight is drawn as its edge is generated, in the same order as 
+ * make_interval_edge_weights.
+ * Returns an array of Edge structures with the |V| - 1 MST edges.
+ */
+Edge *external_kruskal(Graph *g);
+
+/*
+ * set_external_run_edges
+ * the number of edges sorted in memory per run, at least 1024
+ */
+void set_external_run_edges(long run_edges);
+long get_external_run_edges(void);
+
+/*
+ * set_external_run_dir
+ * the directory for the spill files; without one, $TMPDIR if it is set, 
+ * else /var/tmp, since /tmp is often a tmpfs held in memory
+ */
+void set_external_run_dir(char *dir);
+char *get_external_run_dir(void);
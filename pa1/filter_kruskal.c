@@ -0,0 +1,304 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "radix_sort.h"
+#include "union_find.h"
+#include "parallel.h"
+#include "filter_kruskal.h"
+
+#define PIVOT_SAMPLES 31
+#define MIN_CHUNK 65536     // edges per task below which threads don't pay
+
+typedef struct filter_kruskal FilterKruskal;
+typedef struct edge_range EdgeRange;
+
+/* internal structures */
+struct filter_kruskal {
+    UnionFind *uf;
+    Edge *x;                // MST edges found so far
+    int num_mst_edges;
+    int mst_size;
+    Edge *tmp;              // scratch space as large as the edge list
+    int num_threads;
+};
+
+/* one parallel pass over edges [begin, end), split into num_chunks */
+struct edge_range {
+    FilterKruskal *fk;
+    Edge *edges;
+    int begin;
+    int end;
+    int num_chunks;
+    EdgeWeight pivot;
+    int *kept;              // per chunk: edges kept (light, or not filtered)
+    int *dropped;           // per chunk: the others (heavy)
+    int out_size;           // edges written to tmp
+};
+
+/* internal function prototypes */
+void filter_kruskal_range(FilterKruskal *fk, Edge *edges, int begin, int end);
+void kruskal_range(FilterKruskal *fk, Edge *edges, int begin, int end);
+EdgeWeight choose_pivot(Edge *edges, int begin, int end);
+int partition_range(FilterKruskal *fk, Edge *edges, int begin, int end, 
+                    EdgeWeight pivot);
+int filter_range(FilterKruskal *fk, Edge *edges, int begin, int end);
+int split_range(EdgeRange *r, void (*count)(int, void *),
+                void (*scatter)(int, void *));
+void chunk_bounds(EdgeRange *r, int chunk, int *begin, int *end);
+void count_light(int chunk, void *arg);
+void scatter_light(int chunk, void *arg);
+void count_unfiltered(int chunk, void *arg);
+void scatter_unfiltered(int chunk, void *arg);
+void copy_back(int chunk, void *arg);
+int is_filtered(FilterKruskal *fk, Edge *e);
+int compare_weight(const void *p, const void *q);
+
+/* function definitions */
+
+Edge *filter_kruskal(Graph *g) {
+    Edge *x = create_edge_array(get_num_vertices(g) - 1);
+    EdgeList *el = make_graph_edge_list(g, FLT_MAX);
+    filter_kruskal_edge_list(get_num_vertices(g), el, x);
+    destroy_edge_list(el);
+    return x;
+}
+
+int filter_kruskal_edge_list(int num_vertices, EdgeList *el, Edge *x) {
+    FilterKruskal fk;
+    fk.mst_size = num_vertices - 1;
+    fk.x = x;
+    fk.num_mst_edges = 0;
+    fk.num_threads = get_num_threads();
+    fk.uf = create_union_find(num_vertices);
+
+    // ranges are int, which is all an edge list from a matrix can hold
+    if (get_num_edges(el) > INT_MAX)
+        error(1,"filter_kruskal_edge_list: too many edges - try -e "
+              "kruskal\n","");
+    fk.tmp = create_edge_array(get_num_edges(el));
+    filter_kruskal_range(&fk, get_edges(el), 0, get_num_edges(el));
+
+    destroy_edge_array(fk.tmp);
+    destroy_union_find(fk.uf);
+    return fk.num_mst_edges;
+}
+
+void filter_kruskal_range(FilterKruskal *fk, Edge *edges, int begin, int end) {
+    if (fk->num_mst_edges == fk->mst_size || begin >= end)
+        return;
+    if (end - begin <= fk->mst_size + 1 || end - begin <= MIN_CHUNK) {
+        kruskal_range(fk, edges, begin, end);
+        return;
+    }
+
+    EdgeWeight pivot = choose_pivot(edges, begin, end);
+    int mid = partition_range(fk, edges, begin, end, pivot);
+    if (mid == end) {
+        // nothing heavier than the pivot, splitting again would not help
+        kruskal_range(fk, edges, begin, end);
+        return;
+    }
+    filter_kruskal_range(fk, edges, begin, mid);
+    if (fk->num_mst_edges == fk->mst_size)
+        return;
+    end = filter_range(fk, edges, mid, end);
+    filter_kruskal_range(fk, edges, mid, end);
+}
+
+/*
+ * kruskal_range
+ * plain Kruskal on edges [begin, end), adding to the MST found so far
+ */
+void kruskal_range(FilterKruskal *fk, Edge *edges, int begin, int end) {
+    radix_sort_edges(&edges[begin], end - begin);
+    int i;
+    for (i = begin; i < end && fk->num_mst_edges < fk->mst_size; i++) {
+        if (uf_union(fk->uf, get_start_index(&edges[i]), 
+                     get_end_index(&edges[i])))
+            fk->x[fk->num_mst_edges++] = edges[i];
+    }
+}
+
+/*
+ * choose_pivot
+ * return the median weight of PIVOT_SAMPLES edges spread evenly over 
+ * [begin, end)
+ */
+EdgeWeight choose_pivot(Edge *edges, int begin, int end) {
+    EdgeWeight sample[PIVOT_SAMPLES];
+    long step = (end - begin) / PIVOT_SAMPLES;
+    int i;
+    for (i = 0; i < PIVOT_SAMPLES; i++)
+        sample[i] = get_cost(&edges[begin + i * step]);
+    qsort(sample, PIVOT_SAMPLES, sizeof(EdgeWeight), compare_weight);
+    return sample[PIVOT_SAMPLES / 2];
+}
+
+int compare_weight(const void *p, const void *q) {
+    const EdgeWeight w1 = *(const EdgeWeight *) p;
+    const EdgeWeight w2 = *(const EdgeWeight *) q;
+    if (w1 < w2)
+        return -1;
+    if (w1 > w2)
+        return 1;
+    return 0;
+}
+
+/*
+ * partition_range
+ * reorder edges [begin, end) so that those no heavier than pivot come 
+ * first
+ * Returns: the index of the first heavier edge.
+ */
+int partition_range(FilterKruskal *fk, Edge *edges, int begin, int end, 
+                    EdgeWeight pivot) {
+    EdgeRange r;
+    r.fk = fk;
+    r.edges = edges;
+    r.begin = begin;
+    r.end = end;
+    r.pivot = pivot;
+    return begin + split_range(&r, count_light, scatter_light);
+}
+
+/*
+ * filter_range
+ * drop the edges of [begin, end) whose vertices are already connected, 
+ * moving the rest to the front
+ * Returns: the end of the remaining edges.
+ */
+int filter_range(FilterKruskal *fk, Edge *edges, int begin, int end) {
+    EdgeRange r;
+    r.fk = fk;
+    r.edges = edges;
+    r.begin = begin;
+    r.end = end;
+    return begin + split_range(&r, count_unfiltered, scatter_unfiltered);
+}
+
+/*
+ * split_range
+ * Parallel stable split of r's edges: every chunk counts the edges it 
+ * keeps and drops, a prefix sum gives each chunk its output positions, and
+ * every chunk scatters its edges into fk->tmp, kept ones first. A filter 
+ * does not scatter the edges it drops. The result is copied back.
+ * Returns: the number of kept edges.
+ */
+int split_range(EdgeRange *r, void (*count)(int, void *),
+                void (*scatter)(int, void *)) {
+    int num_edges = r->end - r->begin;
+    r->num_chunks = num_edges / MIN_CHUNK;
+    if (r->num_chunks > 4 * r->fk->num_threads)
+        r->num_chunks = 4 * r->fk->num_threads;
+    if (r->num_chunks < 1)
+        r->num_chunks = 1;
+
+    r->kept = malloc(2 * r->num_chunks * sizeof(int));
+    if (r->kept == NULL)
+        error(1,"split_range: cannot malloc chunk counts\n","");
+    r->dropped = r->kept + r->num_chunks;
+
+    parallel_for(r->num_chunks, r->fk->num_threads, count, r);
+
+    // turn the counts into output offsets relative to begin
+    int c, n, kept_total = 0, dropped_offset;
+    for (c = 0; c < r->num_chunks; c++) {
+        n = r->kept[c];
+        r->kept[c] = kept_total;
+        kept_total += n;
+    }
+    dropped_offset = kept_total;
+    for (c = 0; c < r->num_chunks; c++) {
+        n = r->dropped[c];
+        r->dropped[c] = dropped_offset;
+        dropped_offset += n;
+    }
+
+    parallel_for(r->num_chunks, r->fk->num_threads, scatter, r);
+    // a filter leaves only the kept edges in tmp
+    r->out_size = (scatter == scatter_unfiltered) ? kept_total : num_edges;
+    parallel_for(r->num_chunks, r->fk->num_threads, copy_back, r);
+
+    free(r->kept);
+    return kept_total;
+}
+
+void chunk_bounds(EdgeRange *r, int chunk, int *begin, int *end) {
+    long size = r->end - r->begin;
+    *begin = r->begin + (int) (size * chunk / r->num_chunks);
+    *end = r->begin + (int) (size * (chunk + 1) / r->num_chunks);
+}
+
+void count_light(int chunk, void *arg) {
+    EdgeRange *r = arg;
+    int i, begin, end, light = 0;
+    chunk_bounds(r, chunk, &begin, &end);
+    for (i = begin; i < end; i++) {
+        if (get_cost(&r->edges[i]) <= r->pivot)
+            light++;
+    }
+    r->kept[chunk] = light;
+    r->dropped[chunk] = (end - begin) - light;
+}
+
+void scatter_light(int chunk, void *arg) {
+    EdgeRange *r = arg;
+    Edge *out = r->fk->tmp + r->begin;
+    int i, begin, end;
+    int light = r->kept[chunk], heavy = r->dropped[chunk];
+    chunk_bounds(r, chunk, &begin, &end);
+    for (i = begin; i < end; i++) {
+        if (get_cost(&r->edges[i]) <= r->pivot)
+            out[light++] = r->edges[i];
+        else
+            out[heavy++] = r->edges[i];
+    }
+}
+
+void count_unfiltered(int chunk, void *arg) {
+    EdgeRange *r = arg;
+    int i, begin, end, kept = 0;
+    chunk_bounds(r, chunk, &begin, &end);
+    for (i = begin; i < end; i++) {
+        if (!is_filtered(r->fk, &r->edges[i]))
+            kept++;
+    }
+    r->kept[chunk] = kept;
+    r->dropped[chunk] = (end - begin) - kept;
+}
+
+void scatter_unfiltered(int chunk, void *arg) {
+    EdgeRange *r = arg;
+    Edge *out = r->fk->tmp + r->begin;
+    int i, begin, end, kept = r->kept[chunk];
+    chunk_bounds(r, chunk, &begin, &end);
+    for (i = begin; i < end; i++) {
+        // ask again rather than remember: finds are cheap after the count
+        if (!is_filtered(r->fk, &r->edges[i]))
+            out[kept++] = r->edges[i];
+    }
+}
+
+void copy_back(int chunk, void *arg) {
+    EdgeRange *r = arg;
+    long size = r->out_size;
+    int begin = r->begin + (int) (size * chunk / r->num_chunks);
+    int end = r->begin + (int) (size * (chunk + 1) / r->num_chunks);
+    memcpy(&r->edges[begin], &r->fk->tmp[begin], (end - begin) * sizeof(Edge));
+}
+
+/*
+ * is_filtered
+ * return 1 if both ends of e are already in the same component. Only 
+ * called while no unions run, from any number of threads.
+ */
+int is_filtered(FilterKruskal *fk, Edge *e) {
+    return uf_find_concurrent(fk->uf, get_start_index(e)) == 
+           uf_find_concurrent(fk->uf, get_end_index(e));
+}
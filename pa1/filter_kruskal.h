@@ -0,0 +1,21 @@
+
+/*
+ * filter_kruskal
+ * Given a pointer to a graph g determine an MST with Filter-Kruskal 
+ * (Osipov, Sanders and Singler, 2009): split the edges around a pivot 
+ * weight, solve the light side first, then drop every heavy edge whose 
+ * ends are already connected before recursing on the rest, so most heavy
+ * edges are never sorted. Partitioning and filtering run on 
+ * get_num_threads() threads.
+ * Returns an array of Edge structures with the |V| - 1 MST edges.
+ */
+Edge *filter_kruskal(Graph *g);
+
+/*
+ * filter_kruskal_edge_list
+ * The same on an edge list of a graph with num_vertices vertices, which 
+ * need not be complete. The list is reordered in place and the MST edges
+ * go to x, which has room for num_vertices - 1.
+ * Returns the number of edges written to x.
+ */
+int filter_kruskal_edge_list(int num_vertices, EdgeList *el, Edge *x);
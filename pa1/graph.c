@@ -1,16 +1,21 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "graph.h"
+#include "arena.h"
 #include "utils.h"
 
 
 
 Graph *create_graph(int num_vertices) {
-    Graph *g = malloc(sizeof(Graph));
+    Graph *g = trial_malloc(sizeof(Graph));
     if (g == NULL) {
         error(1,"create_graph: cannot malloc Graph\n","");
     }
     g->num_vertices = num_vertices;
+    g->edge_weights = NULL;
+    g->dimension = 0;
+    g->coord = NULL;
+    g->squared_weights = 0;
     if ((g->adj = create_adjacency(num_vertices)) == NULL) {
         return NULL;
     }
@@ -19,7 +24,7 @@ Graph *create_graph(int num_vertices) {
 
 Vertex *create_adjacency(int num_vertices) {
     // array of vertices
-    Vertex *vp = (Vertex*) malloc(num_vertices * sizeof(Vertex));
+    Vertex *vp = (Vertex*) trial_malloc(num_vertices * sizeof(Vertex));
     if (vp == NULL) {
         error(1,"create_adjacency: cannot malloc vertex array\n","");
     }
@@ -39,7 +44,6 @@ void initialize_vertex(Vertex *v) {
     v->num_edge_weights = 0;
     v->edge_weights = NULL;
     v->dimension = 0;
-    v->coord = NULL;
 }
 
 Vertex *get_vertex(Graph *g, int i) {
@@ -69,10 +73,43 @@ EdgeWeight *create_edge_weights(int num_edge_weights) {
     return ep;
 }
 
+/*
+ * create_edge_weight_matrix
+ * Allocate the packed upper triangular weight matrix of g as one block and
+ * point every vertex at its row.
+ */
+void create_edge_weight_matrix(Graph *g) {
+    int n = g->num_vertices, i;
+    long size = packed_index(n, n - 1, n - 1) + 1;
+    if (g->edge_weights != NULL)
+        trial_free(g->edge_weights); // out with the old
+    g->edge_weights = (EdgeWeight*) trial_malloc(size * sizeof(EdgeWeight));
+    if (g->edge_weights == NULL) {
+        error(1,"create_edge_weight_matrix: cannot malloc edge_weights\n","");
+    }
+    for (i = 0; i < n; i++) {
+        set_edge_weights(&g->adj[i], g->edge_weights + packed_index(n, i, i), n);
+    }
+}
+
+/*
+ * packed_index
+ * return the position of the weight between vertices i <= j in the packed 
+ * upper triangle of a num_vertices x num_vertices matrix
+ */
+long packed_index(int num_vertices, int i, int j) {
+    long row = i;
+    return row * num_vertices - row * (row - 1) / 2 + (j - i);
+}
+
+/*
+ * set_edge_weights
+ * point v at its row of a packed weight matrix: edge_weights holds the 
+ * costs from v to vertices v, v+1, ..., num_edge_weights - 1. The row 
+ * belongs to the matrix, not the vertex.
+ */
 void set_edge_weights(Vertex *v, EdgeWeight *edge_weights, int num_edge_weights){
-    if (v->edge_weights != NULL)
-        free(v->edge_weights); // out with the old
-    v->edge_weights = edge_weights; // in with the new
+    v->edge_weights = edge_weights;
     v->num_edge_weights = num_edge_weights;
 }
 
@@ -80,7 +117,12 @@ EdgeWeight *get_edge_weight(Vertex *v, int i) {
     if (i < 0 || i > (v->num_edge_weights-1)) {
         error(1,"get_edge_weight: invalid edge weight index\n","");
     }
-    return &(v->edge_weights[i]);
+    if (i >= v->id)
+        return &(v->edge_weights[i - v->id]);
+    // an earlier vertex: the weight is in column v of row i
+    int n = v->num_edge_weights;
+    return v->edge_weights + 
+           (packed_index(n, i, v->id) - packed_index(n, v->id, v->id));
 }
 
 EdgeWeight get_edge_weight_value(EdgeWeight *ep) {
@@ -91,13 +133,18 @@ void set_edge_weight_value(EdgeWeight *edge_weight, EdgeWeight cost) {
     *edge_weight = cost;
 }
 
+/*
+ * next_edge_weight
+ * step through the weights stored in v's row, i.e. those to v and later 
+ * vertices. Use get_edge_weight for the weights to earlier vertices.
+ */
 EdgeWeight *next_edge_weight(Vertex *v, EdgeWeight *current) {
-    if (current < v->edge_weights || 
-        current >= (v->edge_weights + v->num_edge_weights)) {
+    EdgeWeight *row_end = v->edge_weights + (v->num_edge_weights - v->id);
+    if (current < v->edge_weights || current >= row_end) {
         error(1,"next_edge_weight: invalid current pointer\n","");
     }
     current++;
-    if (current == (v->edge_weights + v->num_edge_weights))
+    if (current == row_end)
         return NULL;
     else
         return current;
@@ -107,6 +154,20 @@ int get_num_vertices(Graph *g) {
     return g->num_vertices;
 }
 
+/*
+ * has_squared_weights
+ * return 1 if the edge weights of g are squared euclidean distances. They
+ * order the edges the same way as the distances do, so an MST engine can
+ * work with them as they are; the MST weight needs the square roots.
+ */
+int has_squared_weights(Graph *g) {
+    return g->squared_weights;
+}
+
+void set_squared_weights(Graph *g, int squared) {
+    g->squared_weights = squared;
+}
+
 int get_dimension(Vertex *v) {
     return v->dimension;
 }
@@ -119,26 +180,48 @@ int get_num_edge_weights(Vertex *v) {
     return v->num_edge_weights;
 }
 
-float *get_coordinates(Vertex *v) {
-    return v->coord;
+/*
+ * create_coordinates
+ * allocate dimension axis arrays for the vertices of g, one block in all
+ */
+void create_coordinates(Graph *g, int dimension) {
+    if (g->coord != NULL)
+        trial_free(g->coord);
+    g->coord = NULL;
+    if (dimension > 0) {
+        g->coord = trial_malloc((size_t) dimension * g->num_vertices 
+                                * sizeof(float));
+        if (g->coord == NULL)
+            error(1,"create_coordinates: cannot malloc coordinates\n","");
+    }
+    g->dimension = dimension;
+    int i;
+    for (i = 0; i < g->num_vertices; i++)
+        g->adj[i].dimension = dimension;
+}
+
+float *get_axis(Graph *g, int axis) {
+    return g->coord + (long) axis * g->num_vertices;
+}
+
+float get_coordinate(Graph *g, int i, int axis) {
+    return g->coord[(long) axis * g->num_vertices + i];
 }
 
 void destroy_graph(Graph *g) {
-    int i;
-    for (i = 0; i < g->num_vertices; i++) { 
-        if (g->adj[i].coord != NULL)
-            free(g->adj[i].coord);
-        free(g->adj[i].edge_weights); // edge arrays
-    }
-    free(g->adj);
-    free(g);
+    // last allocated first, so an arena can take the space back
+    if (g->coord != NULL)
+        trial_free(g->coord);
+    if (g->edge_weights != NULL)
+        trial_free(g->edge_weights); // the whole packed matrix
+    trial_free(g->adj);
+    trial_free(g);
 }
 
 void fill_edge_weights(Vertex *v) {
-    EdgeWeight *p = get_edge_weight(v, 0);
-    while (p != NULL) {
-        set_edge_weight_value(p, 0.5);
-        p = next_edge_weight(v, p);
+    int i;
+    for (i = 0; i < get_num_edge_weights(v); i++) {
+        set_edge_weight_value(get_edge_weight(v, i), 0.5);
     }
 }
 
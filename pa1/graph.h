@@ -4,18 +4,36 @@ typedef struct adjacency Adjacency;
 typedef struct vertex Vertex;
 typedef float EdgeWeight;
 
+#define MAX_DIMENSION 64      // most coordinates per vertex a graph may have
+
 struct graph {
     int num_vertices;
     Vertex *adj;
+    EdgeWeight *edge_weights; // packed upper triangle, NULL if not allocated
+    int dimension;            // number of coordinates per vertex
+    float *coord;             // by axis, [a * num_vertices + i]; NULL if none
+    int squared_weights;      // 1 if weights are squared distances
 };
 
+/*
+ * The weight matrix of an undirected graph is symmetric, so only the upper
+ * triangle (diagonal included) is stored, row after row, in one block:
+ *
+ *       0  1  2
+ *       -------
+ *   0 | a  b  c        a b c d e f
+ *   1 | b  d  e   ->   -----|---|-
+ *   2 | c  e  f        row 0  1  2
+ *
+ * A vertex's edge_weights points at its own row, which starts with its 
+ * cost to itself. Costs to earlier vertices live in their rows.
+ */
 struct vertex {
     int id;
     int explored;
-    int num_edge_weights;
-    EdgeWeight *edge_weights;
+    int num_edge_weights;     // weights to all vertices, stored or not
+    EdgeWeight *edge_weights; // this vertex's row of the packed triangle
     int dimension; // number of coordinates
-    float *coord;  // coordinate values
 };
 
 Graph *create_graph(int num_vertices);
@@ -27,6 +45,8 @@ Vertex *get_vertex(Graph *g, int i);
 Vertex *next_vertex(Graph *g, Vertex *current);
 
 EdgeWeight *create_edge_weights(int num_edge_weights);
+void create_edge_weight_matrix(Graph *g);
+long packed_index(int num_vertices, int i, int j);
 void set_edge_weights(Vertex *v, EdgeWeight *edge_weights,int num_edge_weights);
 EdgeWeight *get_edge_weight(Vertex *v, int i);
 EdgeWeight get_edge_weight_value(EdgeWeight *ep);
@@ -34,10 +54,14 @@ void set_edge_weight_value(EdgeWeight *edge_weight, EdgeWeight cost);
 EdgeWeight *next_edge_weight(Vertex *v, EdgeWeight *current);
 
 int get_num_vertices(Graph *g);
+int has_squared_weights(Graph *g);
+void set_squared_weights(Graph *g, int squared);
 int get_dimension(Vertex *v);
 int get_index(Vertex *v);
 int get_num_edge_weights(Vertex *v);
-float *get_coordinates(Vertex *v);
+void create_coordinates(Graph *g, int dimension);
+float *get_axis(Graph *g, int axis);
+float get_coordinate(Graph *g, int i, int axis);
 
 void fill_edge_weights(Vertex *v);
 void zero_self_costs(Graph *g);
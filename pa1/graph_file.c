@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "graph_file.h"
+
+/* internal function prototypes */
+int check_graph_file_edges(GraphFile *gf);
+uint64_t align_offset(uint64_t offset);
+void write_padding(FILE *f, uint64_t from, uint64_t to);
+
+/* function definitions */
+
+GraphFile *open_graph_file(char *path) {
+    // the edge block is used as an Edge array as it is
+    if (sizeof(Edge) != 2 * sizeof(int32_t) + sizeof(float))
+        error(1,"open_graph_file: Edge does not match the file layout\n","");
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        error(1,path,"- open_graph_file: cannot open\n");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(GraphFileHeader))
+        error(1,path,"- open_graph_file: too short for a graph file\n");
+
+    GraphFile *gf = malloc(sizeof(GraphFile));
+    if (gf == NULL)
+        error(1,"open_graph_file: cannot malloc GraphFile\n","");
+    gf->size = st.st_size;
+    // private and writable: sorting the edges copies the pages it touches
+    gf->map = mmap(NULL, gf->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (gf->map == MAP_FAILED)
+        error(1,path,"- open_graph_file: cannot mmap\n");
+
+    GraphFileHeader *h = gf->header = gf->map;
+    if (strncmp(h->magic, GRAPH_FILE_MAGIC, sizeof(h->magic)) != 0)
+        error(1,path,"- open_graph_file: not a graph file\n");
+    if (h->version != GRAPH_FILE_VERSION)
+        error(1,path,"- open_graph_file: unsupported version\n");
+    if (h->num_vertices > INT_MAX || h->num_edges > LONG_MAX)
+        error(1,path,"- open_graph_file: graph too large\n");
+    if (h->num_vertices == 0)
+        error(1,path,"- open_graph_file: graph has no vertices\n");
+    if (h->edge_offset % sizeof(int32_t) != 0 || h->edge_offset > gf->size ||
+        h->num_edges > (gf->size - h->edge_offset) / sizeof(Edge))
+        error(1,path,"- open_graph_file: edge block out of bounds\n");
+    if (h->coord_offset != 0 && h->dimension > 0) {
+        // divide rather than multiply, which could wrap for a bad header
+        if (h->coord_offset % sizeof(float) != 0 || 
+            h->coord_offset > gf->size ||
+            h->dimension > (gf->size - h->coord_offset) / sizeof(float)
+                           / h->num_vertices)
+            error(1,path,"- open_graph_file: coordinates out of bounds\n");
+    }
+
+    gf->edges.edges = (Edge *) ((char *) gf->map + h->edge_offset);
+    gf->edges.num_edges = (long) h->num_edges;
+    if (!check_graph_file_edges(gf))
+        error(1,path,"- open_graph_file: edge endpoint out of range\n");
+    gf->coord = NULL;
+    if (h->coord_offset != 0 && h->dimension > 0)
+        gf->coord = (float *) ((char *) gf->map + h->coord_offset);
+    return gf;
+}
+
+/*
+ * check_graph_file_edges
+ * returns: 1 if every edge of gf joins two vertices below num_vertices,
+ * which every engine indexes its per-vertex arrays with unchecked
+ */
+int check_graph_file_edges(GraphFile *gf) {
+    Edge *edges = gf->edges.edges;
+    int n = get_graph_file_num_vertices(gf), u, v;
+    long i;
+    for (i = 0; i < gf->edges.num_edges; i++) {
+        u = get_start_index(&edges[i]);
+        v = get_end_index(&edges[i]);
+        if (u < 0 || u >= n || v < 0 || v >= n)
+            return 0;
+    }
+    return 1;
+}
+
+void close_graph_file(GraphFile *gf) {
+    munmap(gf->map, gf->size);
+    free(gf);
+}
+
+int get_graph_file_num_vertices(GraphFile *gf) {
+    return (int) gf->header->num_vertices;
+}
+
+int get_graph_file_dimension(GraphFile *gf) {
+    return (gf->coord != NULL) ? (int) gf->header->dimension : 0;
+}
+
+int has_graph_file_squared_weights(GraphFile *gf) {
+    return (gf->header->flags & GRAPH_FILE_SQUARED) != 0;
+}
+
+EdgeList *get_graph_file_edges(GraphFile *gf) {
+    return &gf->edges;
+}
+
+float *get_graph_file_coordinates(GraphFile *gf) {
+    return gf->coord;
+}
+
+void write_graph_file(char *path, Graph *g) {
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+        error(1,path,"- write_graph_file: cannot open\n");
+
+    int n = get_num_vertices(g);
+    EdgeList *el = NULL;
+    GraphFileHeader h;
+    memset(&h, 0, sizeof(h));
+    strncpy(h.magic, GRAPH_FILE_MAGIC, sizeof(h.magic));
+    h.version = GRAPH_FILE_VERSION;
+    h.flags = has_squared_weights(g) ? GRAPH_FILE_SQUARED : 0;
+    h.num_vertices = n;
+    h.dimension = (g->coord != NULL) ? g->dimension : 0;
+    if (g->edge_weights != NULL) {
+        el = make_graph_edge_list(g, FLT_MAX);
+        h.num_edges = get_num_edges(el);
+    }
+    h.edge_offset = align_offset(sizeof(h));
+    if (h.dimension > 0)
+        h.coord_offset = align_offset(h.edge_offset + 
+                                      h.num_edges * sizeof(Edge));
+
+    int ok = (fwrite(&h, sizeof(h), 1, f) == 1);
+    write_padding(f, sizeof(h), h.edge_offset);
+    if (el != NULL) {
+        ok = ok && (fwrite(get_edges(el), sizeof(Edge), h.num_edges, f) 
+                    == h.num_edges);
+        destroy_edge_list(el);
+    }
+    if (h.dimension > 0) {
+        write_padding(f, h.edge_offset + h.num_edges * sizeof(Edge), 
+                      h.coord_offset);
+        size_t num_coords = (size_t) h.dimension * n;
+        ok = ok && (fwrite(g->coord, sizeof(float), num_coords, f) 
+                    == num_coords);
+    }
+    if (fclose(f) != 0 || !ok)
+        error(1,path,"- write_graph_file: cannot write\n");
+}
+
+uint64_t align_offset(uint64_t offset) {
+    return (offset + GRAPH_FILE_ALIGN - 1) / GRAPH_FILE_ALIGN 
+           * GRAPH_FILE_ALIGN;
+}
+
+void write_padding(FILE *f, uint64_t from, uint64_t to) {
+    for (; from < to; from++)
+        fputc(0, f);
+}
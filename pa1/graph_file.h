@@ -0,0 +1,64 @@
+#include <stdint.h>
+
+typedef struct graph_file GraphFile;
+typedef struct graph_file_header GraphFileHeader;
+
+#define GRAPH_FILE_MAGIC "RANDMST"
+#define GRAPH_FILE_VERSION 1
+#define GRAPH_FILE_SQUARED 1     // flag: weights are squared distances
+#define GRAPH_FILE_ALIGN 64      // blocks start on multiples of this
+
+/*
+ * A graph file, in the byte order of the machine that wrote it:
+ *
+ *   header        GraphFileHeader, padded to GRAPH_FILE_ALIGN
+ *   edges         num_edges records laid out exactly as struct edge:
+ *                 int32 start, int32 end, float32 weight
+ *   coordinates   optional, num_vertices floats per axis, axis after axis
+ *                 as in struct graph
+ *
+ * Blocks start at the offsets the header gives, so a loader can map the
+ * file and use the edge block as an Edge array without reading it.
+ */
+struct graph_file_header {
+    char magic[8];              // GRAPH_FILE_MAGIC, NUL padded
+    uint32_t version;
+    uint32_t flags;
+    uint32_t num_vertices;
+    uint32_t dimension;         // axes in the coordinate block, 0 if none
+    uint64_t num_edges;
+    uint64_t edge_offset;
+    uint64_t coord_offset;      // 0 if there is no coordinate block
+};
+
+/* a graph file mapped into memory */
+struct graph_file {
+    void *map;
+    size_t size;
+    GraphFileHeader *header;
+    EdgeList edges;             // points into the mapping
+    float *coord;               // points into the mapping, NULL if none
+};
+
+/*
+ * open_graph_file
+ * Map the graph file at path copy-on-write, so engines may reorder its
+ * edges in place without changing the file. The header's blocks must lie
+ * within the file and every edge endpoint below num_vertices, which takes
+ * one pass over the edges; exits otherwise.
+ */
+GraphFile *open_graph_file(char *path);
+void close_graph_file(GraphFile *gf);
+
+int get_graph_file_num_vertices(GraphFile *gf);
+int get_graph_file_dimension(GraphFile *gf);
+int has_graph_file_squared_weights(GraphFile *gf);
+EdgeList *get_graph_file_edges(GraphFile *gf);
+float *get_graph_file_coordinates(GraphFile *gf);
+
+/*
+ * write_graph_file
+ * Save g to path: every edge of its weight matrix, if it has one, and its
+ * coordinates, if it has them.
+ */
+void write_graph_file(char *path, Graph *g);
@@ -0,0 +1,100 @@
+#!/bin/bash
+
+# Solve small hand-written graph files with every engine that takes files
+# and check the MST weights. Run from pa1 after make randmst.
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+failed=0
+
+# little-endian fields of the graph file header and blocks
+u32() {
+    printf "$(printf '\\%03o\\%03o\\%03o\\%03o' $(($1 & 255)) \
+        $(($1 >> 8 & 255)) $(($1 >> 16 & 255)) $(($1 >> 24 & 255)))"
+}
+u64() {
+    u32 $(($1 & 0xffffffff))
+    u32 $(($1 >> 32))
+}
+zeros() {
+    head -c "$1" /dev/zero
+}
+
+# header: n dimension num_edges edge_offset coord_offset, padded to 64
+header() {
+    printf 'RANDMST\0'
+    u32 1
+    u32 0
+    u32 "$1"
+    u32 "$2"
+    u64 "$3"
+    u64 "$4"
+    u64 "$5"
+    zeros 16
+}
+
+# expect name weight file engine...
+expect() {
+    local name=$1 weight=$2 file=$3 e out
+    shift 3
+    for e in "$@"; do
+        out=$(./randmst -e "$e" -f "$file" 2>&1 | cut -d' ' -f1)
+        if [ "$out" != "$weight" ]; then
+            echo "FAIL $name -e $e: got $out, want $weight"
+            failed=1
+        fi
+    done
+}
+
+# three points on a line far outside the unit square: (0,0) (100,0) 
+# (200,0), with the edges of the complete graph on them
+{
+    header 3 2 3 64 128
+    u32 0; u32 1; u32 0x42c80000        # 100.0
+    u32 0; u32 2; u32 0x43480000        # 200.0
+    u32 1; u32 2; u32 0x42c80000
+    zeros 28
+    u32 0; u32 0x42c80000; u32 0x43480000
+    u32 0; u32 0; u32 0
+} > "$dir/line.graph"
+expect "points outside the unit cube" 200.000000 "$dir/line.graph" \
+    kruskal lazy filter prim kdtree boruvka csr
+
+# expect_error name file: every engine must reject the file, not crash
+expect_error() {
+    local name=$1 file=$2 e rc
+    for e in kruskal lazy filter prim kdtree boruvka csr; do
+        ./randmst -e "$e" -f "$file" > /dev/null 2>&1
+        rc=$?
+        if [ $rc -ne 1 ]; then
+            echo "FAIL $name -e $e: exit status $rc, want 1"
+            failed=1
+        fi
+    done
+}
+
+# an edge to vertex 5000000 of a 3 vertex graph
+{
+    header 3 0 2 64 0
+    u32 0; u32 1; u32 0x3f800000        # 1.0
+    u32 1; u32 5000000; u32 0x3f800000
+} > "$dir/endpoint.graph"
+expect_error "edge endpoint out of range" "$dir/endpoint.graph"
+
+# a dimension whose coordinate block runs far past the end of the file
+{
+    header 3 0x80000000 1 64 128
+    u32 0; u32 1; u32 0x3f800000
+    zeros 52
+    zeros 64
+} > "$dir/dimension.graph"
+expect_error "coordinate block out of bounds" "$dir/dimension.graph"
+
+# a header with no vertices and nothing after it
+header 0 0 0 64 0 > "$dir/empty.graph"
+expect_error "no vertices" "$dir/empty.graph"
+
+if [ $failed -eq 0 ]; then
+    echo "graph file tests passed"
+fi
+exit $failed
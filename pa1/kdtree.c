@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "distance.h"
+#include "kdtree.h"
+
+/* internal function prototypes */
+int build_kd_node(KDTree *t, int begin, int end, int leaf_size);
+void set_kd_bounds(KDTree *t, KDNode *node);
+int widest_axis(KDTree *t, KDNode *node);
+void select_kd_median(KDTree *t, int begin, int end, int kth, int axis);
+void swap_kd_points(KDTree *t, int i, int j);
+
+/* function definitions */
+
+/*
+ * create_kd_tree
+ * Build a k-d tree over the coordinates of the vertices of g, splitting
+ * each node at the median of its widest axis until it holds at most 
+ * leaf_size points.
+ */
+KDTree *create_kd_tree(Graph *g, int leaf_size) {
+    KDTree *t = malloc(sizeof(KDTree));
+    if (t == NULL)
+        error(1,"create_kd_tree: cannot malloc KDTree\n","");
+
+    int n = get_num_vertices(g), dim = get_dimension(get_vertex(g, 0));
+    int i, j;
+    if (leaf_size < 1)
+        leaf_size = 1;
+
+    t->dimension = dim;
+    t->num_points = n;
+    t->num_nodes = 0;
+    t->index = malloc(n * sizeof(int));
+    t->coord = create_float_array(n * dim);
+    // leaves hold more than leaf_size / 2 points, so this many nodes suffice
+    int max_nodes = 2 * (2 * n / leaf_size + 1);
+    t->nodes = malloc(max_nodes * sizeof(KDNode));
+    t->bounds = create_float_array(2 * max_nodes * dim);
+    if (t->index == NULL || t->coord == NULL || t->nodes == NULL || 
+        t->bounds == NULL)
+        error(1,"create_kd_tree: cannot malloc tree arrays\n","");
+
+    for (i = 0; i < n; i++) {
+        t->index[i] = i;
+        for (j = 0; j < dim; j++)
+            t->coord[i * dim + j] = get_coordinate(g, i, j);
+    }
+
+    build_kd_node(t, 0, n, leaf_size);
+    return t;
+}
+
+void destroy_kd_tree(KDTree *t) {
+    free(t->index);
+    free(t->coord);
+    free(t->nodes);
+    free(t->bounds);
+    free(t);
+}
+
+/*
+ * build_kd_node
+ * Create the node for points [begin, end) and, recursively, its children.
+ * Returns: the index of the new node.
+ */
+int build_kd_node(KDTree *t, int begin, int end, int leaf_size) {
+    int i = t->num_nodes++;
+    KDNode *node = &t->nodes[i];
+    node->begin = begin;
+    node->end = end;
+    node->left = -1;
+    node->right = -1;
+    node->lo = &t->bounds[2 * i * t->dimension];
+    node->hi = node->lo + t->dimension;
+    set_kd_bounds(t, node);
+
+    if (end - begin > leaf_size) {
+        int mid = begin + (end - begin) / 2;
+        select_kd_median(t, begin, end, mid, widest_axis(t, node));
+        // node may move if the children are built after it, so use i
+        int left = build_kd_node(t, begin, mid, leaf_size);
+        int right = build_kd_node(t, mid, end, leaf_size);
+        t->nodes[i].left = left;
+        t->nodes[i].right = right;
+    }
+    return i;
+}
+
+void set_kd_bounds(KDTree *t, KDNode *node) {
+    int i, j, dim = t->dimension;
+    float *p;
+    for (j = 0; j < dim; j++) {
+        node->lo[j] = t->coord[node->begin * dim + j];
+        node->hi[j] = node->lo[j];
+    }
+    for (i = node->begin + 1; i < node->end; i++) {
+        p = get_kd_point(t, i);
+        for (j = 0; j < dim; j++) {
+            if (p[j] < node->lo[j])
+                node->lo[j] = p[j];
+            if (p[j] > node->hi[j])
+                node->hi[j] = p[j];
+        }
+    }
+}
+
+int widest_axis(KDTree *t, KDNode *node) {
+    int j, axis = 0;
+    for (j = 1; j < t->dimension; j++) {
+        if (node->hi[j] - node->lo[j] > node->hi[axis] - node->lo[axis])
+            axis = j;
+    }
+    return axis;
+}
+
+/*
+ * select_kd_median
+ * Reorder points [begin, end) so that the point at kth has the value it 
+ * would have if they were sorted along axis, with smaller values before 
+ * it and larger values after it (quickselect).
+ */
+void select_kd_median(KDTree *t, int begin, int end, int kth, int axis) {
+    int dim = t->dimension;
+    int lo = begin, hi = end - 1, i, j;
+    float pivot;
+    while (lo < hi) {
+        pivot = t->coord[(lo + (hi - lo) / 2) * dim + axis];
+        i = lo;
+        j = hi;
+        while (i <= j) {
+            while (t->coord[i * dim + axis] < pivot)
+                i++;
+            while (t->coord[j * dim + axis] > pivot)
+                j--;
+            if (i <= j) {
+                swap_kd_points(t, i, j);
+                i++;
+                j--;
+            }
+        }
+        if (kth <= j)
+            hi = j;
+        else if (kth >= i)
+            lo = i;
+        else
+            return;
+    }
+}
+
+void swap_kd_points(KDTree *t, int i, int j) {
+    int k, dim = t->dimension, tmp_idx;
+    float tmp;
+    for (k = 0; k < dim; k++) {
+        tmp = t->coord[i * dim + k];
+        t->coord[i * dim + k] = t->coord[j * dim + k];
+        t->coord[j * dim + k] = tmp;
+    }
+    tmp_idx = t->index[i];
+    t->index[i] = t->index[j];
+    t->index[j] = tmp_idx;
+}
+
+KDNode *get_kd_node(KDTree *t, int i) {
+    return &t->nodes[i];
+}
+
+int is_kd_leaf(KDNode *node) {
+    return node->left < 0;
+}
+
+float *get_kd_point(KDTree *t, int pos) {
+    return &t->coord[pos * t->dimension];
+}
+
+/*
+ * kd_point_dist2
+ * returns: the squared euclidean distance between x and y
+ */
+float kd_point_dist2(float *x, float *y, int dimension) {
+    return point_distance2(x, y, dimension);
+}
+
+/*
+ * kd_node_min_dist2
+ * returns: the smallest squared distance between any point in the bounding
+ * box of a and any point in the bounding box of b
+ */
+float kd_node_min_dist2(KDTree *t, KDNode *a, KDNode *b) {
+    float dist2 = 0.0, gap;
+    int j;
+    for (j = 0; j < t->dimension; j++) {
+        gap = 0.0;
+        if (a->hi[j] < b->lo[j])
+            gap = b->lo[j] - a->hi[j];
+        else if (b->hi[j] < a->lo[j])
+            gap = a->lo[j] - b->hi[j];
+        dist2 = dist2 + gap * gap;
+    }
+    return dist2;
+}
@@ -0,0 +1,36 @@
+
+typedef struct kd_tree KDTree;
+typedef struct kd_node KDNode;
+
+/*
+ * A k-d tree over the vertex coordinates of a graph. The points are copied
+ * into tree order so that every node owns the contiguous range 
+ * [begin, end) of coord and index.
+ */
+struct kd_tree {
+    int dimension;
+    int num_points;
+    int num_nodes;
+    int *index;         // vertex index of each point, in tree order
+    float *coord;       // point coordinates, dimension floats per point
+    KDNode *nodes;      // nodes[0] is the root, children follow parents
+    float *bounds;      // storage for the node bounding boxes
+};
+
+struct kd_node {
+    int begin;
+    int end;
+    int left;           // child node indices, -1 for a leaf
+    int right;
+    float *lo;          // bounding box corners, dimension floats each
+    float *hi;
+};
+
+KDTree *create_kd_tree(Graph *g, int leaf_size);
+void destroy_kd_tree(KDTree *t);
+
+KDNode *get_kd_node(KDTree *t, int i);
+int is_kd_leaf(KDNode *node);
+float *get_kd_point(KDTree *t, int pos);
+float kd_point_dist2(float *x, float *y, int dimension);
+float kd_node_min_dist2(KDTree *t, KDNode *a, KDNode *b);
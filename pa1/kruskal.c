@@ -1,43 +1,33 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
 
 #include "utils.h"
+#include "arena.h"
 #include "graph.h"
 #include "random_graph.h"
-#include "disjoint_set.h"
+#include "union_find.h"
 #include "kruskal.h"
-
-typedef struct edge_list EdgeList;
-
-/* internal structures */
-struct edge_list {
-    Edge *edges;
-    int num_edges;
-};
-
+#include "radix_sort.h"
 
 /* internal function prototypes */
-Disjoint_Set *create_graph_disjoint_set(Graph *g);
-int union_if_necessary(Edge *ep, Disjoint_Set *ds);
+int union_if_necessary(Edge *ep, UnionFind *uf);
 
-int compare_edge(const void *p, const void *q);
 
 
-EdgeList *make_graph_edge_list(Graph *g);
-int insert_edges_for_vertex(Graph *g, Vertex *v, Edge *arr, int start_idx);
+int kruskal_below(Graph *g, EdgeWeight max_cost, Edge *x);
+int count_edges_for_vertex(Vertex *v, EdgeWeight max_cost);
+int insert_edges_for_vertex(Vertex *v, Edge *arr, int start_idx,
+                            EdgeWeight max_cost);
 EdgeWeight *get_edge_after_self(Vertex *v, int vertex_idx);
-EdgeList *create_edge_list(int size);
-Edge *get_edges(EdgeList *el);
-int get_num_edges(EdgeList *el);
-void set_num_edges(EdgeList *el, int n);
-void destroy_edge_list(EdgeList *el);
-
-Edge *create_edge_array(int num_edges);
+EdgeList *create_edge_list(long size);
+void set_num_edges(EdgeList *el, long n);
 
 void copy_edge(Edge *src, Edge *dest);
-void populate_edge(Edge *e, Vertex *v, Vertex *w, EdgeWeight *ewp);
-
-EdgeWeight k(int num_vertices, int dimension);
+void heapify_edges(Edge *edges, long num_edges);
+void sift_down_edge(Edge *edges, long num_edges, long i);
 
 /* function definitions */
 
@@ -47,83 +37,153 @@ EdgeWeight k(int num_vertices, int dimension);
  * Returns and array of Edge structures with the |V| - 1 MST edges.
  */
 Edge *kruskal(Graph *g) {
-    EdgeList *el = make_graph_edge_list(g);
-    qsort(get_edges(el), get_num_edges(el), sizeof(Edge), compare_edge);
+    int mst_size = get_num_vertices(g) - 1;
+    Edge *x = create_edge_array(mst_size);
+    kruskal_below(g, FLT_MAX, x);
+    return x;
+}
 
-    Disjoint_Set *ds = create_graph_disjoint_set(g);    
-    
+/*
+ * pruned_kruskal
+ * Run Kruskal on only the edges no heavier than k(n, dimension). If those
+ * do not connect the graph, the MST needs a heavier edge, so retry with 
+ * twice the threshold until they do. Squared weights get squared 
+ * thresholds.
+ */
+Edge *pruned_kruskal(Graph *g) {
+    int mst_size = get_num_vertices(g) - 1;
+    Edge *x = create_edge_array(mst_size);
+    EdgeWeight max_cost = k(get_num_vertices(g), 
+                            get_dimension(get_vertex(g, 0)));
+    EdgeWeight growth = 2.0;
+    if (has_squared_weights(g) && max_cost < FLT_MAX) {
+        max_cost = max_cost * max_cost;
+        growth = 4.0;
+    }
+    while (!kruskal_below(g, max_cost, x)) {
+        max_cost = growth * max_cost;
+    }
+    return x;
+}
+
+/*
+ * lazy_kruskal
+ * Only the lightest edges up to the heaviest MST edge are ever needed, 
+ * which on random geometric graphs are a small part of the list. Building
+ * the heap is O(E) and each pop O(log E), so the full sort is skipped.
+ */
+Edge *lazy_kruskal(Graph *g, long *num_examined, long *num_edges) {
     int mst_size = get_num_vertices(g) - 1;
-    Edge *x = malloc(mst_size * sizeof(Edge));
-    if (x == NULL)
-        error(1,"kruskal: cannot malloc Edge pointers\n","");
+    Edge *x = create_edge_array(mst_size);
+    EdgeList *el = make_graph_edge_list(g, FLT_MAX);
+    lazy_kruskal_edge_list(get_num_vertices(g), el, x, num_examined);
+    if (num_edges != NULL)
+        *num_edges = get_num_edges(el);
+    destroy_edge_list(el);
+    return x;
+}
 
+int lazy_kruskal_edge_list(int num_vertices, EdgeList *el, Edge *x, 
+                           long *num_examined) {
     Edge *edges = get_edges(el);
-    Edge *one_edge;
-    int i, j = 0;
-    for (i = 0; i < get_num_edges(el); i++) {
-        one_edge = &edges[i];
-        if (union_if_necessary(one_edge, ds)) {
-            copy_edge(one_edge, &x[j++]);
+    long heap_size = get_num_edges(el);
+    heapify_edges(edges, heap_size);
+
+    UnionFind *uf = create_union_find(num_vertices);
+    Edge lightest;
+    int j = 0;
+    while (get_num_components(uf) > 1 && heap_size > 0) {
+        // pop: move the last edge to the root and let it sink
+        lightest = edges[0];
+        edges[0] = edges[--heap_size];
+        sift_down_edge(edges, heap_size, 0);
+        if (union_if_necessary(&lightest, uf)) {
+            copy_edge(&lightest, &x[j++]);
         }
     }
 
-    destroy_edge_list(el);
-    return x;
+    if (num_examined != NULL)
+        *num_examined = get_num_edges(el) - heap_size;
+    destroy_union_find(uf);
+    return j;
 }
 
 /*
- * union_if_necessary
- * Given a pointer to an edge, checks if the edge's two vertices are in 
- * the same set of the Disjoint_Set structure pointed to by ds.
- * Returns: 1 if the vertices were unioned, 0 otherwise.
- * Note: Calls find on the items of ds associated with the edge vertices.
+ * heapify_edges
+ * Arrange edges into a binary min-heap on weight, bottom up in O(E).
  */
-int union_if_necessary(Edge *ep, Disjoint_Set *ds) {
-        Vertex *u = get_start_vertex(ep);
-        Vertex *v = get_end_vertex(ep);
-        int u_idx = get_index(u);
-        int v_idx = get_index(v);
-        DSItem *u_item = get_item_by_index(ds, u_idx);
-        DSItem *v_item = get_item_by_index(ds, v_idx);
-
-        if ( find(u_item) != find(v_item) ) {
-            union_ds(ds, u_item, v_item);
-            return 1;
-        }
-        return 0;
+void heapify_edges(Edge *edges, long num_edges) {
+    long i;
+    for (i = num_edges / 2 - 1; i >= 0; i--)
+        sift_down_edge(edges, num_edges, i);
 }
 
-Disjoint_Set *create_graph_disjoint_set(Graph *g) {
-    Disjoint_Set *ds = create_disjoint_set(get_num_vertices(g));
-    DSItem *cur = get_items(ds);
-    int i;
-    for (i = 0; i < get_num_vertices(g); i++) {
-        makeset(cur);
-        cur++;
+void sift_down_edge(Edge *edges, long num_edges, long i) {
+    Edge e = edges[i];
+    long child;
+    while ((child = 2 * i + 1) < num_edges) {
+        if (child + 1 < num_edges && 
+            get_cost(&edges[child + 1]) < get_cost(&edges[child]))
+            child++;
+        if (get_cost(&edges[child]) >= get_cost(&e))
+            break;
+        edges[i] = edges[child];
+        i = child;
     }
-    return ds;
+    edges[i] = e;
+}
+
+/*
+ * kruskal_below
+ * Run Kruskal's algorithm on the edges of g that weigh at most max_cost,
+ * storing the spanning forest edges in x.
+ * Returns: 1 if the edges connect all vertices, 0 otherwise.
+ */
+int kruskal_below(Graph *g, EdgeWeight max_cost, Edge *x) {
+    EdgeList *el = make_graph_edge_list(g, max_cost);
+    int num_mst_edges = kruskal_edge_list(get_num_vertices(g), el, x);
+    destroy_edge_list(el);
+    return num_mst_edges == get_num_vertices(g) - 1;
 }
 
-int compare_edge(const void *p, const void *q) {
-    const Edge *edge1 = p;
-    const Edge *edge2 = q;
+int kruskal_edge_list(int num_vertices, EdgeList *el, Edge *x) {
+    radix_sort_edges(get_edges(el), get_num_edges(el));
 
-    const EdgeWeight ew1 = get_cost(edge1);
-    const EdgeWeight ew2 = get_cost(edge2);
+    UnionFind *uf = create_union_find(num_vertices);
 
-    if (ew1 < ew2)
-        return -1;
-    if (ew1 > ew2)
-        return 1;
-    return 0;
+    Edge *edges = get_edges(el);
+    Edge *one_edge;
+    long i;
+    int j = 0;
+    for (i = 0; i < get_num_edges(el); i++) {
+        one_edge = &edges[i];
+        if (union_if_necessary(one_edge, uf)) {
+            copy_edge(one_edge, &x[j++]);
+            if (j == num_vertices - 1)
+                break;          // the tree is complete
+        }
+    }
+
+    destroy_union_find(uf);
+    return j;
+}
+
+/*
+ * union_if_necessary
+ * Given a pointer to an edge, merges the sets of its two vertices in uf if
+ * they are different.
+ * Returns: 1 if the vertices were unioned, 0 otherwise.
+ */
+int union_if_necessary(Edge *ep, UnionFind *uf) {
+    return uf_union(uf, get_start_index(ep), get_end_index(ep));
 }
 
 EdgeWeight get_cost(const Edge *ep) {
-    return get_edge_weight_value(ep->weight);
+    return ep->weight;
 }
 
-EdgeList *create_edge_list(int size) {
-    EdgeList *el = malloc(sizeof(EdgeList));
+EdgeList *create_edge_list(long size) {
+    EdgeList *el = trial_malloc(sizeof(EdgeList));
     if (el == NULL)
         error(1,"create_edge_list: could not malloc EdgeList","");
 
@@ -132,16 +192,16 @@ EdgeList *create_edge_list(int size) {
     return el;
 }
 
-Vertex *get_start_vertex(Edge *ep) {
+int get_start_index(Edge *ep) {
     return ep->start;
 }
 
-Vertex *get_end_vertex(Edge *ep) {
+int get_end_index(Edge *ep) {
     return ep->end;
 }
 
-Edge *create_edge_array(int num_edges) {
-    Edge *edges = malloc(num_edges * sizeof(Edge));
+Edge *create_edge_array(long num_edges) {
+    Edge *edges = trial_malloc(num_edges * sizeof(Edge) + 1);
     if (edges == NULL)
         error(1,"create_edge: could not malloc Edge array","");
     return edges;
@@ -151,33 +211,49 @@ void copy_edge(Edge *src, Edge *dest) {
     populate_edge(dest, src->start, src->end, src->weight);
 }
 
-void populate_edge(Edge *e, Vertex *v, Vertex *w, EdgeWeight *ewp) {
+void populate_edge(Edge *e, int v, int w, EdgeWeight cost) {
     e->start = v;
     e->end = w;
-    e->weight = ewp;
+    e->weight = cost;
 }
 
 Edge *get_edges(EdgeList *el) {
     return el->edges;
 }
 
-int get_num_edges(EdgeList *el) {
+long get_num_edges(EdgeList *el) {
     return el->num_edges;
 }
 
-void set_num_edges(EdgeList *el, int n) {
+void set_num_edges(EdgeList *el, long n) {
     el->num_edges = n;
 }
 
-EdgeList *make_graph_edge_list(Graph *g) {
-    int max_edges = triangular_number(get_num_vertices(g) - 1);
+/*
+ * make_graph_edge_list
+ * List the edges of g that weigh at most max_cost. Unless max_cost keeps
+ * every edge, the edges are counted first so that the list is only as 
+ * large as it needs to be.
+ */
+EdgeList *make_graph_edge_list(Graph *g, EdgeWeight max_cost) {
+    long max_edges = triangular_number(get_num_vertices(g) - 1);
+    Vertex *vp;
+    if (max_cost < FLT_MAX) {
+        max_edges = 0;
+        for (vp = get_vertex(g, 0); vp != NULL; vp = next_vertex(g, vp))
+            max_edges += count_edges_for_vertex(vp, max_cost);
+    }
+    if (max_edges > INT_MAX)
+        error(1,"make_graph_edge_list: too many edges for memory - try "
+              "-e external\n","");
+
     EdgeList *el = create_edge_list(max_edges);
     Edge *edges = get_edges(el);
     int edges_idx = 0;
 
-    Vertex *vp = get_vertex(g, 0);
+    vp = get_vertex(g, 0);
     while (vp != NULL) {
-        edges_idx = insert_edges_for_vertex(g, vp, edges, edges_idx);
+        edges_idx = insert_edges_for_vertex(vp, edges, edges_idx, max_cost);
         vp = next_vertex(g, vp);
     }
 
@@ -188,11 +264,11 @@ EdgeList *make_graph_edge_list(Graph *g) {
 
 void destroy_edge_list(EdgeList *el) {
     destroy_edge_array(el->edges);
-    free(el);
+    trial_free(el);
 }
 
 void destroy_edge_array(Edge *e) {
-    free(e);
+    trial_free(e);
 }
 
 EdgeWeight *get_edge_after_self(Vertex *v, int vertex_idx) {
@@ -202,19 +278,31 @@ EdgeWeight *get_edge_after_self(Vertex *v, int vertex_idx) {
     return ewp;
 }
 
-int insert_edges_for_vertex(Graph *g, Vertex *v, Edge *arr, int start_idx) {
+int count_edges_for_vertex(Vertex *v, EdgeWeight max_cost) {
+    EdgeWeight *ewp = get_edge_after_self(v, get_index(v));
+    int count = 0;
+    while (ewp != NULL) {
+        if (get_edge_weight_value(ewp) <= max_cost)
+            count++;
+        ewp = next_edge_weight(v, ewp);
+    }
+    return count;
+}
+
+int insert_edges_for_vertex(Vertex *v, Edge *arr, int start_idx,
+                            EdgeWeight max_cost) {
     /* prep for this specific vertex */
     int cur_v_id = get_index(v);
     int to_v_id = cur_v_id + 1;
     EdgeWeight *ewp = get_edge_after_self(v, cur_v_id);
-    int max_cost = k(get_num_vertices(g), get_dimension(v));
 
     int edges_idx = start_idx; // where to start filling the array
 
     while (ewp != NULL) {
         if (get_edge_weight_value(ewp) <= max_cost) {
             // add Edge data to edges array
-            populate_edge(&arr[edges_idx], v, get_vertex(g,to_v_id), ewp);
+            populate_edge(&arr[edges_idx], cur_v_id, to_v_id, 
+                          get_edge_weight_value(ewp));
             edges_idx++;
         }
         ewp = next_edge_weight(v, ewp);
@@ -226,43 +314,43 @@ int insert_edges_for_vertex(Graph *g, Vertex *v, Edge *arr, int start_idx) {
 
 /*
  * k
- * return the maximum weight expected of any edge in an MST for
- * graph with size num_vertices and dimension 0, 2, 3, 4.
+ * return a weight that the heaviest edge of an MST for a random graph with
+ * num_vertices vertices and dimension 0 or 2 and up is unlikely to exceed.
+ *
+ * dimension 0: the MST of a random complete graph is found within the 
+ * edges lighter than about ln(n) / n, which is where G(n, p) connects.
+ * dimension d: n random points connect once balls of radius r, with
+ * n * V_d * r^d = ln(n), around them touch (V_d the unit ball volume).
+ * Points near the cube boundary have fewer neighbors, so both get a 
+ * safety factor. Kept edges drop from n^2 / 2 to O(n log n). Past 
+ * dimension 4, V_d = pi^(d/2) / Gamma(d/2 + 1); the boundary matters more
+ * there, and pruned_kruskal's retries cover what the factor misses.
  */
 EdgeWeight k(int num_vertices, int dimension) {
-    return 2.0;
-/*
-this function is incomplete so it just returns 2.0
-
-below are expected values for the distance between two points 
-randomly chosen from the entities from this assignment
-from http://mathworld.wolfram.com/HypercubeLinePicking.html
-
-this function should also be dependent on the number of vertices
-*/
-
-    EdgeWeight exp0 = 0.3333333;
-    EdgeWeight exp2 = 0.5214054;
-    EdgeWeight exp3 = 0.6617072;
-    EdgeWeight exp4 = 0.7776657;
+    double n = num_vertices;
+    double ball_volume;
+    if (num_vertices < 16)
+        return FLT_MAX; // too small to be worth pruning
     switch (dimension) {
         case 0:
-            return exp0;
-            break;
+            return 2.0 * log(n) / n;
         case 2:
-            return exp2;
+            ball_volume = M_PI;
             break;
         case 3:
-            return exp3;
+            ball_volume = 4.0 * M_PI / 3.0;
             break;
         case 4:
-            return exp4;
+            ball_volume = M_PI * M_PI / 2.0;
             break;
         default:
-            error(1,"k: invalid dimension","");
-            return 1;
+            if (dimension < 2)
+                error(1,"k: invalid dimension","");
+            ball_volume = pow(M_PI, dimension / 2.0) / 
+                          tgamma(dimension / 2.0 + 1.0);
             break;
     }
+    return 1.5 * pow(log(n) / (n * ball_volume), 1.0 / dimension);
 }
 
 /*
@@ -283,7 +371,7 @@ int main() {
             if (1 == 0) {
                 printf(" crd: ");
                 for(i = 0; i < dim; i++)
-                    printf("%f ",vp->coord[i]);
+                    printf("%f ",get_coordinate(g, vp->id, i));
             }
             printf(" wt: ");
             ewp = get_edge_weight(vp, 0);
@@ -297,14 +385,14 @@ int main() {
         }
     }
 
-    Edge *mst = kruskal(g); //make_graph_edge_list(g);
+    Edge *mst = kruskal(g); //make_graph_edge_list(g, FLT_MAX);
 
     if (!big_graph) {
         printf("Edges in MST\n");
         printf("u v cost\n");
         for (i = 0; i < num_v-1; i++) {
-            printf("%d ",get_index(get_start_vertex(&mst[i])));
-            printf("%d ",get_index(get_end_vertex(&mst[i])));
+            printf("%d ",get_start_index(&mst[i]));
+            printf("%d ",get_end_index(&mst[i]));
             printf("%f \n", get_cost(&mst[i]));
         }
     }
@@ -1,10 +1,20 @@
 
 typedef struct edge Edge;
+typedef struct edge_list EdgeList;
 
+/*
+ * an edge by the indices of its vertices, with its weight stored inline so
+ * that sorting and union-find passes read only the contiguous edge array
+ */
 struct edge {
-    Vertex *start;
-    Vertex *end;
-    EdgeWeight *weight;
+    int start;
+    int end;
+    EdgeWeight weight;
+};
+
+struct edge_list {
+    Edge *edges;
+    long num_edges;
 };
 
 /*
@@ -14,8 +24,44 @@ struct edge {
  */
 Edge *kruskal(Graph *g);
 
+/*
+ * pruned_kruskal
+ * Like kruskal, but considers only the edges below a weight threshold that
+ * depends on |V| and the dimension, raising the threshold if those edges 
+ * do not connect the graph.
+ */
+Edge *pruned_kruskal(Graph *g);
+
+/*
+ * lazy_kruskal
+ * Like kruskal, but heapifies the edge list in O(E) instead of sorting it
+ * and pops edges only until the tree has |V| - 1 edges. The number of 
+ * edges popped goes to *num_examined and the size of the edge list to 
+ * *num_edges, if those are not NULL.
+ */
+Edge *lazy_kruskal(Graph *g, long *num_examined, long *num_edges);
+
+/*
+ * kruskal_edge_list, lazy_kruskal_edge_list
+ * The same on an edge list of a graph with num_vertices vertices, which 
+ * need not be complete. The list is reordered in place. The MST (or 
+ * spanning forest) edges go to x, which has room for num_vertices - 1.
+ * Returns the number of edges written to x.
+ */
+int kruskal_edge_list(int num_vertices, EdgeList *el, Edge *x);
+int lazy_kruskal_edge_list(int num_vertices, EdgeList *el, Edge *x, 
+                           long *num_examined);
+EdgeWeight k(int num_vertices, int dimension);
+
 EdgeWeight get_cost (const Edge *ep);
-Vertex *get_start_vertex(Edge *ep);
-Vertex *get_end_vertex(Edge *ep);
+int get_start_index(Edge *ep);
+int get_end_index(Edge *ep);
+Edge *create_edge_array(long num_edges);
+void populate_edge(Edge *e, int v, int w, EdgeWeight cost);
 void destroy_edge_array(Edge *e);
 
+EdgeList *make_graph_edge_list(Graph *g, EdgeWeight max_cost);
+Edge *get_edges(EdgeList *el);
+long get_num_edges(EdgeList *el);
+void destroy_edge_list(EdgeList *el);
+
@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "parallel.h"
+
+typedef struct task_queue TaskQueue;
+
+/* internal structures */
+struct task_queue {
+    int num_tasks;
+    int next_task;          // taken atomically
+    void (*task)(int, void *);
+    void *arg;
+};
+
+/* threads a parallel MST engine may use, 0 until set */
+static int num_engine_threads = 0;
+
+/* internal function prototypes */
+void *task_worker(void *arg);
+
+/* function definitions */
+
+void run_parallel(int num_threads, void *(*worker)(void *), void *arg) {
+    if (num_threads <= 1) {
+        worker(arg);
+        return;
+    }
+
+    pthread_t *threads = malloc(num_threads * sizeof(pthread_t));
+    if (threads == NULL)
+        error(1,"run_parallel: cannot malloc threads\n","");
+
+    int i;
+    for (i = 0; i < num_threads; i++) {
+        if (pthread_create(&threads[i], NULL, worker, arg) != 0)
+            error(1,"run_parallel: cannot create thread\n","");
+    }
+    for (i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+}
+
+void parallel_for(int num_tasks, int num_threads, 
+                  void (*task)(int, void *), void *arg) {
+    TaskQueue q;
+    q.num_tasks = num_tasks;
+    q.next_task = 0;
+    q.task = task;
+    q.arg = arg;
+    if (num_threads > num_tasks)
+        num_threads = num_tasks;
+    run_parallel(num_threads, task_worker, &q);
+}
+
+void *task_worker(void *arg) {
+    TaskQueue *q = arg;
+    int i;
+    while ((i = __atomic_fetch_add(&q->next_task, 1, __ATOMIC_RELAXED)) 
+           < q->num_tasks) {
+        q->task(i, q->arg);
+    }
+    return NULL;
+}
+
+/*
+ * get_num_cpus
+ * return the number of online processors, at least 1
+ */
+int get_num_cpus(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n < 1) ? 1 : (int) n;
+}
+
+/*
+ * set_num_threads
+ * set how many threads each parallel MST engine runs on
+ */
+void set_num_threads(int num_threads) {
+    num_engine_threads = num_threads;
+}
+
+/*
+ * get_num_threads
+ * return how many threads each parallel MST engine runs on, by default 
+ * one per processor
+ */
+int get_num_threads(void) {
+    if (num_engine_threads < 1)
+        return get_num_cpus();
+    return num_engine_threads;
+}
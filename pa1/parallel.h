@@ -0,0 +1,20 @@
+
+/*
+ * run_parallel
+ * Start num_threads threads that each call worker(arg), and wait for all 
+ * of them to return. With num_threads <= 1 worker runs on the calling 
+ * thread. Workers share arg and split the work among themselves.
+ */
+void run_parallel(int num_threads, void *(*worker)(void *), void *arg);
+
+/*
+ * parallel_for
+ * Call task(i, arg) for every i in 0 .. num_tasks - 1 on num_threads 
+ * threads, which take the next task index as they finish one.
+ */
+void parallel_for(int num_tasks, int num_threads, 
+                  void (*task)(int, void *), void *arg);
+
+int get_num_cpus(void);
+void set_num_threads(int num_threads);
+int get_num_threads(void);
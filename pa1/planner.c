@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "graph_file.h"
+#include "engine.h"
+#include "parallel.h"
+#include "external_kruskal.h"
+#include "planner.h"
+
+#define NS 1e-9
+#define RUN_EDGE_BYTES 32.0     // run chunk plus radix sort scratch
+
+/* internal function prototypes */
+double parallel_speedup(void);
+
+/* function definitions */
+
+/*
+ * estimate_engine
+ * The constants are bench totals at n = 2048 and 16384 on one core, per 
+ * edge of the complete graph (E = n(n-1)/2), per vertex pair for Prim, 
+ * or per n log2 n for the tree and sampling engines. Only their ratios 
+ * matter for the choice.
+ */
+int estimate_engine(Engine e, int dim, int num_vertices, Plan *p) {
+    double n = num_vertices, edges = n * (n - 1) / 2.0;
+    double n_log_n = n * log2(n > 2 ? n : 2);
+    // the k-d tree gets slower quickly with the dimension, about 2.4 times
+    // per axis past the measured ones
+    static const double kdtree_ns[] = {440.0, 1000.0, 2400.0};
+    p->engine = e;
+    switch (e) {
+        case ENGINE_KRUSKAL:
+            p->seconds = 110 * NS * edges;
+            p->bytes = 36 * edges + 16 * n;   // matrix, list, sort scratch
+            break;
+        case ENGINE_PRUNED:
+            p->seconds = 12 * NS * edges;
+            p->bytes = 5 * edges + 32 * n;    // matrix and a short list
+            break;
+        case ENGINE_CSR:
+            p->seconds = 14 * NS * edges;
+            p->bytes = 5 * edges + 48 * n;
+            break;
+        case ENGINE_LAZY:
+            p->seconds = 40 * NS * edges;
+            p->bytes = 16 * edges + 16 * n;
+            break;
+        case ENGINE_FILTER:
+            p->seconds = 47 * NS * edges / parallel_speedup();
+            p->bytes = 28 * edges + 16 * n;
+            break;
+        case ENGINE_BORUVKA:
+            p->seconds = 100 * NS * edges / parallel_speedup();
+            p->bytes = 4 * edges + 32 * n;
+            break;
+        case ENGINE_PRIM:
+            p->seconds = 3 * NS * n * n;
+            p->bytes = (20 + 4 * dim) * n;
+            break;
+        case ENGINE_KDTREE:
+            if (dim < 2)
+                return 0;
+            if (dim <= 4)
+                p->seconds = kdtree_ns[dim - 2] * NS * n_log_n;
+            else
+                p->seconds = kdtree_ns[2] * pow(2.4, dim - 4) * NS * n_log_n;
+            p->bytes = (60 + 12 * dim) * n;
+            break;
+        case ENGINE_SPARSE:
+            if (dim != 0)
+                return 0;
+            p->seconds = 65 * NS * n_log_n;
+            p->bytes = 200 * n;
+            break;
+        case ENGINE_EXTERNAL:
+            // generation and sorting as Kruskal, plus a disk round trip
+            p->seconds = 150 * NS * edges;
+            p->bytes = RUN_EDGE_BYTES * fmin(edges, get_external_run_edges())
+                       + (16 + 4 * dim) * n;
+            break;
+        default:
+            return 0;
+    }
+    return 1;
+}
+
+Engine plan_engine(int dim, int num_vertices, double mem_limit, FILE *log) {
+    Plan p, best = {ENGINE_KRUSKAL, 0.0, 0.0};
+    int e, found = 0;
+    for (e = 0; e < ENGINE_AUTO; e++) {
+        if (!estimate_engine((Engine) e, dim, num_vertices, &p))
+            continue;
+        if (mem_limit > 0 && p.bytes > mem_limit)
+            continue;
+        if (!found || p.seconds < best.seconds) {
+            best = p;
+            found = 1;
+        }
+    }
+    if (!found)
+        error(2,"plan_engine: memory limit too small for any engine\n","");
+
+    if (log != NULL) {
+        fprintf(log, "auto: chose %s for n = %d, dimension %d: about %.3g s "
+                "and %.3g MB per trial", get_engine_name(best.engine), 
+                num_vertices, dim, best.seconds, best.bytes / 1e6);
+        if (mem_limit > 0)
+            fprintf(log, ", limit %.3g MB", mem_limit / 1e6);
+        fprintf(log, "\n");
+    }
+    return best.engine;
+}
+
+/*
+ * parallel_speedup
+ * the threads a parallel engine gets, no more than there are CPUs
+ */
+double parallel_speedup(void) {
+    int threads = get_num_threads(), cpus = get_num_cpus();
+    return (threads < cpus) ? threads : cpus;
+}
+
+double parse_memory_size(char *s) {
+    char *end;
+    double size = strtod(s, &end);
+    if (end == s || size < 0)
+        return -1;
+    switch (*end) {
+        case 'k': case 'K': size *= 1024.0; end++; break;
+        case 'm': case 'M': size *= 1024.0 * 1024.0; end++; break;
+        case 'g': case 'G': size *= 1024.0 * 1024.0 * 1024.0; end++; break;
+        case 't': case 'T': size *= 1024.0 * 1024.0 * 1024.0 * 1024.0; 
+                            end++; break;
+    }
+    if (*end == 'B' || *end == 'b')
+        end++;
+    return (*end == '\0') ? size : -1;
+}
+
+double get_physical_memory(void) {
+    long pages = sysconf(_SC_PHYS_PAGES), page_size = sysconf(_SC_PAGESIZE);
+    if (pages < 1 || page_size < 1)
+        return 0.0;
+    return (double) pages * page_size;
+}
@@ -0,0 +1,35 @@
+typedef struct plan Plan;
+
+/* what one trial of an engine is expected to cost */
+struct plan {
+    Engine engine;
+    double seconds;
+    double bytes;           // peak memory of one trial
+};
+
+/*
+ * estimate_engine
+ * Fill p with the time and memory one trial of engine e takes on num_vertices
+ * vertices in dimension dim, from per-edge and per-vertex costs measured 
+ * with bench. Parallel engines are credited with get_num_threads() 
+ * threads, up to the number of CPUs.
+ * Returns 0 if e cannot run in dim.
+ */
+int estimate_engine(Engine e, int dim, int num_vertices, Plan *p);
+
+/*
+ * plan_engine
+ * Pick the fastest engine whose trials fit in mem_limit bytes each (no 
+ * limit if mem_limit <= 0), and log the choice and its estimate to log, 
+ * if it is not NULL. Exits if no engine fits.
+ * Returns the chosen engine.
+ */
+Engine plan_engine(int dim, int num_vertices, double mem_limit, FILE *log);
+
+/*
+ * parse_memory_size
+ * Read a size such as 512M, 4G or 100000 (bytes).
+ * Returns the size in bytes, or -1 if s is not a size.
+ */
+double parse_memory_size(char *s);
+double get_physical_memory(void);
@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "distance.h"
+#include "kruskal.h"
+#include "prim.h"
+
+typedef struct frontier Frontier;
+
+/* internal structures */
+
+/*
+ * the vertices not yet in the tree, kept packed at the front of each array
+ * so that every scan of the frontier reads memory sequentially
+ */
+struct frontier {
+    int size;
+    int dimension;
+    int *id;            // vertex index
+    int *parent;        // closest tree vertex found so far
+    EdgeWeight *key;    // weight of the edge to parent
+    float *coord;       // coordinates, dimension floats per entry
+};
+
+/* internal function prototypes */
+Frontier *create_frontier(Graph *g);
+void destroy_frontier(Frontier *f);
+void remove_from_frontier(Frontier *f, int pos);
+int relax_frontier(Frontier *f, int u, float *u_coord);
+
+/* function definitions */
+
+Edge *prim(Graph *g) {
+    int num_vertices = get_num_vertices(g);
+    int mst_size = num_vertices - 1;
+    Edge *x = create_edge_array(mst_size);
+    if (num_vertices < 2)
+        return x;
+
+    Frontier *f = create_frontier(g);
+    int dim = f->dimension;
+    float *u_coord = create_float_array(dim);
+
+    // start the tree from the last frontier entry, vertex n - 1
+    int pos = f->size - 1, j, u, i = 0;
+    while (f->size > 0) {
+        u = f->id[pos];
+        for (j = 0; j < dim; j++)
+            u_coord[j] = f->coord[pos * dim + j];
+        if (i > 0) {
+            populate_edge(&x[i-1], f->parent[pos], u, f->key[pos]);
+        }
+        remove_from_frontier(f, pos);
+        pos = relax_frontier(f, u, u_coord);
+        i++;
+    }
+
+    free(u_coord);
+    destroy_frontier(f);
+    return x;
+}
+
+/*
+ * relax_frontier
+ * Update the frontier with the edges from the newly added tree vertex u.
+ * Returns: the frontier position with the smallest key, -1 if it is empty.
+ */
+int relax_frontier(Frontier *f, int u, float *u_coord) {
+    int pos, best = -1, dim = f->dimension;
+    EdgeWeight w, best_key = 0.0;
+    PointKernel distance2 = select_point_kernel(dim);
+    for (pos = 0; pos < f->size; pos++) {
+        if (dim == 0)
+            w = random_float(0,1);
+        else
+            w = sqrtf(distance2(u_coord, &f->coord[pos * dim], dim));
+        if (w < f->key[pos] || f->parent[pos] < 0) {
+            f->key[pos] = w;
+            f->parent[pos] = u;
+        }
+        if (best < 0 || f->key[pos] < best_key) {
+            best = pos;
+            best_key = f->key[pos];
+        }
+    }
+    return best;
+}
+
+/*
+ * remove_from_frontier
+ * Drop the entry at pos by moving the last entry into its place.
+ */
+void remove_from_frontier(Frontier *f, int pos) {
+    int last = f->size - 1, j, dim = f->dimension;
+    f->id[pos] = f->id[last];
+    f->parent[pos] = f->parent[last];
+    f->key[pos] = f->key[last];
+    for (j = 0; j < dim; j++)
+        f->coord[pos * dim + j] = f->coord[last * dim + j];
+    f->size--;
+}
+
+Frontier *create_frontier(Graph *g) {
+    Frontier *f = malloc(sizeof(Frontier));
+    if (f == NULL)
+        error(1,"create_frontier: cannot malloc Frontier\n","");
+
+    int n = get_num_vertices(g), i, j;
+    int dim = get_dimension(get_vertex(g, 0));
+    f->size = n;
+    f->dimension = dim;
+    f->id = malloc(n * sizeof(int));
+    f->parent = malloc(n * sizeof(int));
+    f->key = create_edge_weights(n);
+    f->coord = (dim > 0) ? create_float_array(n * dim) : NULL;
+    if (f->id == NULL || f->parent == NULL || (dim > 0 && f->coord == NULL))
+        error(1,"create_frontier: cannot malloc frontier arrays\n","");
+
+    for (i = 0; i < n; i++) {
+        f->id[i] = i;
+        f->parent[i] = -1;
+        f->key[i] = FLT_MAX;     // not yet reached from the tree
+        for (j = 0; j < dim; j++)
+            f->coord[i * dim + j] = get_coordinate(g, i, j);
+    }
+    return f;
+}
+
+void destroy_frontier(Frontier *f) {
+    free(f->id);
+    free(f->parent);
+    free(f->key);
+    if (f->coord != NULL)
+        free(f->coord);
+    free(f);
+}
@@ -0,0 +1,12 @@
+
+/*
+ * prim
+ * Given a pointer to a graph g that holds only vertex coordinates (no edge
+ * weight matrix) determine an MST using O(n^2) time, O(n) memory Prim.
+ * Distances for dimensions 2 and up are computed from the coordinates as
+ * they are needed. For dimension 0 each edge weight is drawn from [0,1] the
+ * one time Prim looks at it, which gives the same distribution as a fully
+ * generated graph.
+ * Returns an array of Edge structures with the |V| - 1 MST edges.
+ */
+Edge *prim(Graph *g);
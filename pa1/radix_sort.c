@@ -0,0 +1,102 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "radix_sort.h"
+
+#define RADIX_BITS 8
+#define RADIX (1 << RADIX_BITS)
+#define RADIX_PASSES (32 / RADIX_BITS)
+
+/* internal function prototypes */
+void count_digits(unsigned int *keys, long n, unsigned long counts[][RADIX]);
+
+/* function definitions */
+
+void radix_sort_edges(Edge *edges, long num_edges) {
+    if (num_edges < 2)
+        return;
+
+    unsigned int *keys = malloc(2 * (size_t) num_edges * sizeof(unsigned int));
+    Edge *tmp_edges = malloc(num_edges * sizeof(Edge));
+    if (keys == NULL || tmp_edges == NULL)
+        error(1,"radix_sort_edges: cannot malloc sort buffers\n","");
+    unsigned int *tmp_keys = keys + num_edges;
+
+    long i;
+    for (i = 0; i < num_edges; i++)
+        keys[i] = float_sort_key(get_cost(&edges[i]));
+
+    unsigned long counts[RADIX_PASSES][RADIX];
+    count_digits(keys, num_edges, counts);
+
+    unsigned int *src_keys = keys, *dst_keys = tmp_keys, *swap_keys;
+    Edge *src = edges, *dst = tmp_edges, *swap;
+    unsigned long offset, total;
+    unsigned int digit;
+    int pass, shift, d;
+    for (pass = 0; pass < RADIX_PASSES; pass++) {
+        shift = pass * RADIX_BITS;
+        // every key has the same digit here, so the pass would not move them
+        if (counts[pass][(src_keys[0] >> shift) & (RADIX - 1)] == num_edges)
+            continue;
+
+        // turn digit counts into the first output slot for each digit
+        total = 0;
+        for (d = 0; d < RADIX; d++) {
+            offset = counts[pass][d];
+            counts[pass][d] = total;
+            total += offset;
+        }
+        for (i = 0; i < num_edges; i++) {
+            digit = (src_keys[i] >> shift) & (RADIX - 1);
+            offset = counts[pass][digit]++;
+            dst_keys[offset] = src_keys[i];
+            dst[offset] = src[i];
+        }
+
+        swap_keys = src_keys;
+        src_keys = dst_keys;
+        dst_keys = swap_keys;
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != edges)
+        memcpy(edges, src, num_edges * sizeof(Edge));
+    free(keys);
+    free(tmp_edges);
+}
+
+/*
+ * count_digits
+ * count how often each digit value occurs in each digit position of keys,
+ * for all passes in one read of the keys
+ */
+void count_digits(unsigned int *keys, long n, unsigned long counts[][RADIX]) {
+    long i;
+    int pass;
+    memset(counts, 0, RADIX_PASSES * RADIX * sizeof(unsigned long));
+    for (i = 0; i < n; i++) {
+        for (pass = 0; pass < RADIX_PASSES; pass++)
+            counts[pass][(keys[i] >> (pass * RADIX_BITS)) & (RADIX - 1)]++;
+    }
+}
+
+/*
+ * float_sort_key
+ * map the bits of f to an unsigned int that sorts in the same order as f:
+ * non-negative floats only need their sign bit set, negative ones have 
+ * all bits flipped so that larger magnitudes come first
+ */
+unsigned int float_sort_key(float f) {
+    unsigned int bits;
+    memcpy(&bits, &f, sizeof(bits));
+    if (bits & 0x80000000u)
+        return ~bits;
+    return bits | 0x80000000u;
+}
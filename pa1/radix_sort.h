@@ -0,0 +1,10 @@
+
+/*
+ * radix_sort_edges
+ * Sort num_edges edges by cost, lightest first, with a stable LSD radix 
+ * sort on the bits of the float costs. Takes linear time and reads and 
+ * writes memory sequentially, apart from one pass to fetch the costs.
+ */
+void radix_sort_edges(Edge *edges, long num_edges);
+
+unsigned int float_sort_key(float f);
@@ -1,80 +1,236 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <ctype.h>
 #include <time.h>
+#include <unistd.h>
+#include <getopt.h>
 
 #include "utils.h"
 #include "graph.h"
 #include "random_graph.h"
-#include "disjoint_set.h"
 #include "kruskal.h"
+#include "graph_file.h"
+#include "engine.h"
+#include "external_kruskal.h"
+#include "trials.h"
+#include "sweep.h"
+#include "parallel.h"
+#include "planner.h"
+#include "batch.h"
 
-EdgeWeight compute_mst_weight(Graph *g, Edge *edges);
+#define USAGE "usage: randmst [-e engine] [-j threads] [-t threads] [-q] " \
+              "[-r runedges] [-d rundir] [-w graphfile] [-c ciwidth] " \
+              "[--mem-limit size] seed numpoints numtrials dimension\n" \
+              "       randmst [-e engine] [-t threads] -f graphfile\n" \
+              "       randmst [-j threads] [-q] -s n1,n2,... " \
+              "seed numtrials dimension\n" \
+              "       randmst [-e engine] [-j threads] [-p threads] " \
+              "[-t threads] [-q] [--mem-limit size] -b jobfile\n" \
+              "engines: kruskal pruned filter boruvka prim kdtree sparse " \
+              "lazy csr external auto\n"
+
+#define MAX_SIZES 64
+
+static struct option long_options[] = {
+    {"mem-limit", required_argument, NULL, 'm'},
+    {NULL, 0, NULL, 0}
+};
 
 int main(int argc, char * argv[]) {
     /* input validation */
-    if (argc != 5)
-        error(1,"usage: randmst 0 numpoints numtrials dimension\n", "");
-
-    // note: atoi returns 0 if input is not an integer
-    int flag = atoi(argv[1]);
-    int numpoints = atoi(argv[2]);
-    int numtrials = atoi(argv[3]);
-    int dim = atoi(argv[4]);
+    Engine engine = ENGINE_KRUSKAL;
+    int num_threads = 1;
+    int num_producers = 0, engine_given = 0;
+    char *graph_in = NULL, *graph_out = NULL, *batch_in = NULL;
+    double ci_width = 0.0;
+    int sizes[MAX_SIZES], num_sizes = 0;
+    double mem_limit = 0.0;
+    char *size;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "e:j:p:t:qf:w:r:d:c:s:m:b:", long_options,
+                              NULL)) != -1) {
+        switch (opt) {
+            case 'e':
+                engine = parse_engine(optarg);
+                engine_given = 1;
+                break;
+            case 'j':
+                // number of trials to run at once
+                num_threads = atoi(optarg);
+                break;
+            case 'p':
+                // batch threads generating graphs, -j solve them
+                num_producers = atoi(optarg);
+                break;
+            case 't':
+                // number of threads for each parallel engine
+                set_num_threads(atoi(optarg));
+                break;
+            case 'q':
+                // sort squared distances, take square roots of MST edges
+                set_squared_distances(1);
+                break;
+            case 'f':
+                // solve the graph in this file instead of random ones
+                graph_in = optarg;
+                break;
+            case 'c':
+                // stop once the 95% CI is this wide relative to the mean,
+                // numtrials is then the most trials to run
+                ci_width = atof(optarg);
+                break;
+            case 'm':
+                // memory for all trials running at once, e.g. 4G
+                if ((mem_limit = parse_memory_size(optarg)) <= 0)
+                    error(1,USAGE,"");
+                break;
+            case 's':
+                // sweep these sizes, each prefix of the largest graph
+                for (size = strtok(optarg, ","); size != NULL; 
+                     size = strtok(NULL, ",")) {
+                    if (num_sizes == MAX_SIZES)
+                        error(1,USAGE,"");
+                    sizes[num_sizes++] = atoi(size);
+                }
+                break;
+            case 'r':
+                // edges per sorted run of the external engine
+                set_external_run_edges(atol(optarg));
+                break;
+            case 'd':
+                // directory for the external engine's spill files
+                set_external_run_dir(optarg);
+                break;
+            case 'w':
+                // also save the random graphs to graph files
+                graph_out = optarg;
+                break;
+            case 'b':
+                // run the job lines of this file, - for stdin
+                batch_in = optarg;
+                break;
+            default:
+                error(1,USAGE,"");
+        }
+    }
+    if (batch_in != NULL) {
+        if (argc - optind != 0 || graph_in != NULL || graph_out != NULL ||
+            num_sizes > 0 || ci_width > 0.0)
+            error(1,USAGE,"");
+        if (num_producers == 0)
+            num_producers = num_threads;
+        if (num_producers < 1 || num_threads < 1)
+            error(2,"randmst: threads must be positive\n","");
+        FILE *in = (strcmp(batch_in, "-") == 0) ? stdin 
+                                                 : fopen(batch_in, "r");
+        if (in == NULL)
+            error(1,batch_in,"- randmst: cannot open job file\n");
+        if (mem_limit <= 0)
+            mem_limit = 0.8 * get_physical_memory();
+        // a graph per producer, per queue slot and per consumer
+        run_batch(in, engine, num_producers, num_threads,
+                  mem_limit / (num_producers + 2 * num_threads));
+        if (in != stdin)
+            fclose(in);
+        return 0;
+    }
+    if (graph_in != NULL) {
+        if (argc - optind != 0)
+            error(1,USAGE,"");
+        GraphFile *gf = open_graph_file(graph_in);
+        EdgeWeight weight = graph_file_mst_weight(engine, gf);
+        // output: weight numpoints numtrials dimension, as for random graphs
+        printf("%f %d %d %d\n", weight, get_graph_file_num_vertices(gf), 1,
+               get_graph_file_dimension(gf));
+        close_graph_file(gf);
+        return 0;
+    }
+    if (num_sizes > 0) {
+        // sweeps always solve incrementally, one graph per trial
+        if (argc - optind != 3 || engine_given || ci_width > 0.0 ||
+            graph_out != NULL || mem_limit > 0)
+            error(1,USAGE,"");
+        argv += optind;
+        unsigned long flag = strtoul(argv[0], NULL, 10);
+        int numtrials = atoi(argv[1]);
+        int dim = atoi(argv[2]);
+        int k;
+        if (!is_random_dimension(dim))
+            error(2,"randmst: dimension must be 0 or 2 to 64\n","");
+        if (numtrials < 1 || num_threads < 1)
+            error(2,"randmst: numtrials and threads must be positive\n","");
+        for (k = 0; k < num_sizes; k++) {
+            if (sizes[k] < 1 || (k > 0 && sizes[k] < sizes[k - 1]))
+                error(2,"randmst: sweep sizes must be positive and "
+                      "increasing\n","");
+        }
 
-    if (!(dim == 0 || dim == 2 || dim == 3 || dim == 4)) {
-        error(2,"randmst: dimension must be 0, 2, 3, or 4\n","");
+        unsigned long seed = (flag != 0) ? flag : (unsigned long) time(NULL);
+        double avg[MAX_SIZES];
+        run_sweep_trials(dim, sizes, num_sizes, numtrials, num_threads, seed,
+                         avg);
+        // output: one line per size, as a run for that size would print
+        for (k = 0; k < num_sizes; k++)
+            printf("%f %d %d %d\n", avg[k], sizes[k], numtrials, dim);
+        return 0;
     }
+    if (argc - optind != 4)
+        error(1,USAGE,"");
+    argv += optind;
 
-    // keep compiler from complaining about unused variables
-    if (flag != 0)
-        printf("flag\n");
+    // note: atoi returns 0 if input is not an integer
+    unsigned long flag = strtoul(argv[0], NULL, 10);
+    int numpoints = atoi(argv[1]);
+    int numtrials = atoi(argv[2]);
+    int dim = atoi(argv[3]);
 
-    // seed random number generator
-    srandom(time(NULL));
+    if (!is_random_dimension(dim)) {
+        error(2,"randmst: dimension must be 0 or 2 to 64\n","");
+    }
 
-    Graph *g;
-    EdgeWeight weight[numtrials]; // storage for several MST weights
+    if (numtrials < 1 || num_threads < 1)
+        error(2,"randmst: numtrials and threads must be positive\n","");
 
-    /* compute MST and weight */
-    int i;
-    for (i = 0; i < numtrials; i++) {
-        g = create_random_graph(dim, numpoints);
-        // compute MST and weight
-        Edge *mst = kruskal(g);
-        weight[i] = compute_mst_weight(g, mst);
-        destroy_edge_array(mst);
-        destroy_graph(g);
+    /* compute MST weights, trial i from random stream i of the seed */
+    // flag 0 asks for a fresh seed, anything else is the seed to reproduce
+    unsigned long seed = (flag != 0) ? flag : (unsigned long) time(NULL);
+    if (engine == ENGINE_AUTO) {
+        // without a limit, leave a fifth of the machine to everything else
+        if (mem_limit <= 0)
+            mem_limit = 0.8 * get_physical_memory();
+        int at_once = (num_threads < numtrials) ? num_threads : numtrials;
+        engine = plan_engine(dim, numpoints, mem_limit / at_once, stderr);
     }
-
-    /* report results */
-    double avg = 0.0;
-    for (i = 0; i < numtrials; i++) {
-        avg = avg + weight[i];
+    if (graph_out != NULL && !solves_matrix_graph(engine, dim))
+        error(2,"randmst: -w needs an engine that solves the weight matrix "
+              "graph in dimension 0\n","");
+    if (graph_out != NULL)
+        write_trial_graphs(graph_out, dim, numpoints, numtrials, seed);
+    double avg;
+    if (ci_width > 0.0) {
+        TrialStats stats;
+        numtrials = run_adaptive_trials(engine, dim, numpoints, ci_width, 
+                                        numtrials, num_threads, seed, &stats);
+        avg = stats.mean;
+        fprintf(stderr, "ci: %f +- %f (relative width %f, target %f) "
+                "after %d trials\n", stats.mean, get_ci_half_width(&stats),
+                get_relative_ci_width(&stats), ci_width, numtrials);
+    } else {
+        avg = run_trials(engine, dim, numpoints, numtrials, num_threads, 
+                         seed);
     }
-    avg = avg / numtrials;
 
     // output: average numpoints numtrials dimension
     printf("%f %d %d %d\n", avg, numpoints, numtrials, dim);
 
-    return 0;
-}
-
-EdgeWeight compute_mst_weight(Graph *g, Edge *mst) {
-    int i;
-    // testing only:
-    //EdgeWeight max = 0.0; 
-    EdgeWeight tot_weight = 0.0;
-    for (i = 0; i < get_num_vertices(g) - 1; i++) {
-        //testing only
-        //if (get_cost(&mst[i]) > max)
-        //    max = get_cost(&mst[i]);
-
-         tot_weight += get_cost(&mst[i]);
+    if (engine == ENGINE_LAZY) {
+        long num_examined, num_edges;
+        get_edges_examined(&num_examined, &num_edges);
+        fprintf(stderr, "lazy: examined %ld of %ld edges (%.2f%%)\n",
+                num_examined, num_edges, 
+                num_edges ? 100.0 * num_examined / num_edges : 0.0);
     }
-    // testing only:
-    //printf("dim: %d num vertices: %d max weight: %f\n",
-    //    get_dimension(get_vertex(g,0)), get_num_vertices(g), max);
-    return tot_weight;
-}
 
+    return 0;
+}
@@ -5,26 +5,61 @@
 #include "utils.h"
 #include "graph.h"
 #include "random_graph.h"
+#include "distance.h"
+
+/* vertices per tile of the distance kernel, sized so the tile's
+ * coordinates stay in L1 while every earlier row is filled against it */
+#define DISTANCE_TILE 512
+
+int is_random_dimension(int dim) {
+    return dim == 0 || (dim >= 2 && dim <= MAX_DIMENSION);
+}
 
 Graph *create_random_graph(int dim, int num_vertices) {
     Graph *g = create_graph(num_vertices);
-    if (dim == 0 || dim == 2 || dim == 3 || dim == 4) {
+    if (is_random_dimension(dim)) {
         load_graph(g, dim);
     } else {
-        error(1,"create_random_graph: invalid dimension - try 0, 2, 3, 4\n","");
+        error(1,"create_random_graph: invalid dimension - try 0 or 2 to 64\n","");
     }
     return g;
 }
 
-void load_graph(Graph *g, int dimension) {
-    Vertex *vp = get_vertex(g, 0);
-    EdgeWeight *ep;
-    int num_vertices = get_num_vertices(g);
-    while(vp != NULL) {
-        ep = create_edge_weights(num_vertices);
-        set_edge_weights(vp, ep, num_vertices);
-        vp = next_vertex(g, vp);
+/*
+ * create_random_squared_graph
+ * Like create_random_graph, but for dimensions 2 and up the weight matrix 
+ * holds squared distances, which skips a square root per pair. Only the 
+ * MST edges need one later (see compute_mst_weight).
+ */
+Graph *create_random_squared_graph(int dim, int num_vertices) {
+    Graph *g = create_graph(num_vertices);
+    set_squared_weights(g, dim != 0);
+    if (is_random_dimension(dim)) {
+        load_graph(g, dim);
+    } else {
+        error(1,"create_random_squared_graph: invalid dimension - try 0 or 2 to 64\n","");
     }
+    return g;
+}
+
+/*
+ * create_random_point_graph
+ * Like create_random_graph but without the n x n edge weight matrix: only 
+ * the vertex coordinates are generated (none for dimension 0), so the 
+ * graph takes O(n) memory. For engines that compute weights on the fly.
+ */
+Graph *create_random_point_graph(int dim, int num_vertices) {
+    Graph *g = create_graph(num_vertices);
+    if (!is_random_dimension(dim)) {
+        error(1,"create_random_point_graph: invalid dimension - try 0 or 2 to 64\n","");
+    } else if (dim != 0) {
+        set_random_coordinates(g, dim);
+    }
+    return g;
+}
+
+void load_graph(Graph *g, int dimension) {
+    create_edge_weight_matrix(g);
     if (dimension == 0)
         make_interval_edge_weights(g);
     else {
@@ -59,85 +94,56 @@ void make_interval_edge_weights(Graph *g) {
     }
 }
 
+/*
+ * make_cube_edge_weights
+ * input: g, pointer to an undirected graph, and dim, 2 to MAX_DIMENSION
+ * action: place the vertices at random in the unit dim-cube and set the
+ *         edge costs to the euclidean distances, or to their squares if 
+ *         g has squared weights. The packed rows are 
+ *         filled one tile of columns at a time with the vector kernel.
+ */
 void make_cube_edge_weights(Graph *g, int dim) {
     set_random_coordinates(g, dim);
+    make_distance_edge_weights(g);
+}
 
-    if (get_num_vertices(g) < 2)
+/*
+ * make_distance_edge_weights
+ * input: g, pointer to an undirected graph with coordinates and an edge 
+ *        weight matrix
+ * action: set the edge costs to the distances between the coordinates, 
+ *         as make_cube_edge_weights does once it has placed the points.
+ */
+void make_distance_edge_weights(Graph *g) {
+    int n = get_num_vertices(g), dim = g->dimension;
+    if (n < 2)
         return; // no edge_weights to compute
 
-    Vertex *vp, *other_v;
-
-    vp = get_vertex(g, 0);
-    while(vp != NULL) {
-        // start calculating from the current vertex
-        other_v = vp; 
-        while (other_v != NULL) {
-            set_euclidean_edge_weights(vp, other_v);
-            other_v = next_vertex(g, other_v);
+    int tile_begin, tile_end, i, begin;
+    for (tile_begin = 0; tile_begin < n; tile_begin += DISTANCE_TILE) {
+        tile_end = tile_begin + DISTANCE_TILE;
+        if (tile_end > n)
+            tile_end = n;
+        // every row i < tile_end has columns max(i, tile_begin) .. in it
+        for (i = 0; i < tile_end; i++) {
+            begin = (i > tile_begin) ? i : tile_begin;
+            distance_row(g->coord, n, dim, i, begin, tile_end,
+                         has_squared_weights(g),
+                         get_edge_weight(get_vertex(g, i), begin));
         }
-        vp = next_vertex(g, vp);
     }
 }
 
-void set_euclidean_edge_weights(Vertex *v, Vertex *w) {
-    EdgeWeight *ep = get_edge_weight(v, get_index(w));
-    float dist = euclidean_distance(get_coordinates(v), get_coordinates(w), 
-                                    get_dimension(v));
-    set_edge_weight_value(ep, dist);
-}
-
-
 void set_random_coordinates(Graph *g, int dim) {
-    Vertex *vp = get_vertex(g, 0);
-    float *coordinates;
-    int i;
-    while(vp != NULL) {
-        coordinates = create_float_array(dim);
-        for(i = 0; i < dim; i++)
-            coordinates[i] = random_float(0,1);
-        vp->coord = coordinates;
-        vp->dimension = dim;
-        vp = next_vertex(g, vp);
-    }
-}
-
-/*
- * copy_symmetric_edge_costs
- * input: g, pointer to an undirected graph that has an adjacency matrix 
- * with only the upper right triangle populated.
- * action: copy over the edge costs as illustrated below:
- *
- *       0  1  2            0  1  2
- *       -------            -------
- *   0 | 0  x  y        0 | 0  x  y
- *   1 | -  0  z   ->   1 | x  0  z
- *   2 | -  -  0        2 | y  z  0
- */
-void copy_symmetric_edge_costs(Graph *g) {
-    if (get_num_vertices(g) < 2)
-        return; // nothing to copy
-
-    Vertex *vp = get_vertex(g, 1), *prev_vertex;
-    int current_v_idx = 1, i;
-    EdgeWeight *ep, *prev_ep;
-    while(vp != NULL) {
-        for(i=0; i < current_v_idx; i++) {
-            // the cost from the current vertex to vertex i is equal to 
-            // the cost from vertex i to the current vertex
-            prev_vertex = get_vertex(g, i);
-            prev_ep = get_edge_weight(prev_vertex, current_v_idx); 
-            ep = get_edge_weight(vp, i);
-            set_edge_weight_value(ep,get_edge_weight_value(prev_ep));
-        }
-        vp = next_vertex(g, vp);
-        current_v_idx++;
+    int n = get_num_vertices(g), i, j;
+    create_coordinates(g, dim);
+    // draw vertex by vertex, so each vertex keeps the same random point
+    for (i = 0; i < n; i++) {
+        for(j = 0; j < dim; j++)
+            g->coord[(long) j * n + i] = random_float(0,1);
     }
 }
 
-
-
-
-
 /*
 int main() {
     int i;
@@ -145,8 +151,6 @@ int main() {
     Graph *g = create_random_graph(dim, 3);
     printf("gnv %d\n", get_num_vertices(g));
 
-    copy_symmetric_edge_costs(g);
-
     EdgeWeight *ep;
     Vertex *vt;
     vt = get_vertex(g, 0);
@@ -181,7 +185,7 @@ int main() {
         if (dim > 0) {
             printf(" crd: ");
             for(i = 0; i < dim; i++)
-                printf("%f ",vt->coord[i]);
+                printf("%f ",get_coordinate(g, vt->id, i));
         }
         printf(" wt: ");
         ep = get_edge_weight(vt, 0);
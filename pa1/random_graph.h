@@ -1,9 +1,16 @@
+/*
+ * is_random_dimension
+ * returns: 1 if random graphs can be made in dimension dim: 0 for random
+ * edge weights, or 2 to MAX_DIMENSION for points in the unit cube
+ */
+int is_random_dimension(int dim);
 
 Graph *create_random_graph(int dim, int num_vertices);
+Graph *create_random_point_graph(int dim, int num_vertices);
+Graph *create_random_squared_graph(int dim, int num_vertices);
 void make_cube_edge_weights(Graph *g, int dim);
-void set_euclidean_edge_weights(Vertex *v, Vertex *w);
+void make_distance_edge_weights(Graph *g);
 void set_random_coordinates(Graph *g, int dim);
 void make_interval_edge_weights(Graph *g);
 void load_graph(Graph *g, int dimension);
-void copy_symmetric_edge_costs(Graph *g);
 
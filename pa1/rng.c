@@ -0,0 +1,66 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "rng.h"
+
+/* internal function prototypes */
+uint64_t mix64(uint64_t z);
+
+/* function definitions */
+
+/*
+ * init_random_stream
+ * position rs at the start of stream number stream of the given seed
+ */
+void init_random_stream(RandomStream *rs, uint64_t seed, uint64_t stream) {
+    rs->key[0] = mix64(seed ^ mix64(stream));
+    rs->key[1] = mix64(rs->key[0] + stream);
+    rs->counter = 0;
+}
+
+/*
+ * skip_random_stream
+ * jump ahead n numbers in constant time
+ */
+void skip_random_stream(RandomStream *rs, uint64_t n) {
+    rs->counter += n;
+}
+
+/*
+ * next_random_bits
+ * return 64 random bits: two keyed rounds of the splitmix64 finalizer over
+ * the counter
+ */
+uint64_t next_random_bits(RandomStream *rs) {
+    uint64_t x = mix64(rs->counter + rs->key[0]);
+    rs->counter++;
+    return mix64(x ^ rs->key[1]);
+}
+
+/*
+ * next_random_float
+ * return a random float in [0, 1) with all 24 bits of precision random
+ */
+float next_random_float(RandomStream *rs) {
+    return (next_random_bits(rs) >> 40) * (1.0f / 16777216.0f);
+}
+
+/*
+ * next_random_double
+ * return a random double in [0, 1) with all 53 bits of precision random
+ */
+double next_random_double(RandomStream *rs) {
+    return (next_random_bits(rs) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * mix64
+ * the splitmix64 finalizer, a bijection on 64-bit words that scrambles
+ * every input bit into every output bit
+ */
+uint64_t mix64(uint64_t z) {
+    z = z + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,20 @@
+#include <stdint.h>
+
+typedef struct random_stream RandomStream;
+
+/*
+ * A counter-based random number generator: the i-th number of a stream 
+ * is a fixed hash of (key, i), so streams need no shared state, any 
+ * position can be jumped to directly, and (seed, stream) pairs name 
+ * independent, reproducible sequences.
+ */
+struct random_stream {
+    uint64_t key[2];
+    uint64_t counter;
+};
+
+void init_random_stream(RandomStream *rs, uint64_t seed, uint64_t stream);
+void skip_random_stream(RandomStream *rs, uint64_t n);
+uint64_t next_random_bits(RandomStream *rs);
+float next_random_float(RandomStream *rs);
+double next_random_double(RandomStream *rs);
@@ -0,0 +1,367 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+#include <float.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "union_find.h"
+#include "sparse_graph.h"
+
+typedef struct vertex_heap VertexHeap;
+
+/* internal structures */
+
+/* binary min-heap of vertices keyed by their cheapest edge to the tree */
+struct vertex_heap {
+    int size;
+    int *heap;              // vertices, heap ordered by key
+    int *pos;               // position of each vertex in heap, -1 if absent
+    EdgeWeight *key;
+};
+
+/* internal function prototypes */
+SparseGraph *allocate_sparse_graph(int num_vertices, long num_edges);
+int lighter_arc(SparseGraph *sg, int u, long a, int w, long b);
+
+VertexHeap *create_vertex_heap(int num_vertices);
+void destroy_vertex_heap(VertexHeap *h);
+void heap_decrease_key(VertexHeap *h, int v, EdgeWeight key);
+int heap_pop(VertexHeap *h);
+void heap_sift_up(VertexHeap *h, int i);
+void heap_sift_down(VertexHeap *h, int i);
+void heap_place(VertexHeap *h, int i, int v);
+
+/* function definitions */
+
+SparseGraph *create_sparse_graph(int num_vertices, Edge *edges,
+                                 long num_edges) {
+    SparseGraph *sg = allocate_sparse_graph(num_vertices, num_edges);
+    long *next = malloc((num_vertices + 1) * sizeof(long));
+    if (next == NULL)
+        error(1,"create_sparse_graph: cannot malloc offsets\n","");
+    long i;
+    int v, u, w;
+
+    // count the degrees, then turn them into row offsets
+    for (v = 0; v <= num_vertices; v++)
+        sg->offset[v] = 0;
+    for (i = 0; i < num_edges; i++) {
+        sg->offset[get_start_index(&edges[i]) + 1]++;
+        sg->offset[get_end_index(&edges[i]) + 1]++;
+    }
+    for (v = 0; v < num_vertices; v++)
+        sg->offset[v + 1] += sg->offset[v];
+
+    // then drop each edge into both of its rows
+    for (v = 0; v <= num_vertices; v++)
+        next[v] = sg->offset[v];
+    for (i = 0; i < num_edges; i++) {
+        u = get_start_index(&edges[i]);
+        w = get_end_index(&edges[i]);
+        sg->neighbor[next[u]] = w;
+        sg->weight[next[u]++] = get_cost(&edges[i]);
+        sg->neighbor[next[w]] = u;
+        sg->weight[next[w]++] = get_cost(&edges[i]);
+    }
+
+    free(next);
+    return sg;
+}
+
+SparseGraph *create_pruned_sparse_graph(Graph *g, EdgeWeight max_cost) {
+    EdgeList *el = make_graph_edge_list(g, max_cost);
+    SparseGraph *sg = create_sparse_graph(get_num_vertices(g),
+                                          get_edges(el), get_num_edges(el));
+    sg->squared_weights = has_squared_weights(g);
+    destroy_edge_list(el);
+    return sg;
+}
+
+SparseGraph *allocate_sparse_graph(int num_vertices, long num_edges) {
+    SparseGraph *sg = malloc(sizeof(SparseGraph));
+    if (sg == NULL)
+        error(1,"create_sparse_graph: cannot malloc SparseGraph\n","");
+    sg->num_vertices = num_vertices;
+    sg->num_edges = num_edges;
+    sg->squared_weights = 0;
+    sg->offset = malloc((num_vertices + 1) * sizeof(long));
+    sg->neighbor = malloc(2 * num_edges * sizeof(int) + 1);
+    sg->weight = malloc(2 * num_edges * sizeof(EdgeWeight) + 1);
+    if (sg->offset == NULL || sg->neighbor == NULL || sg->weight == NULL)
+        error(1,"create_sparse_graph: cannot malloc rows\n","");
+    return sg;
+}
+
+void destroy_sparse_graph(SparseGraph *sg) {
+    free(sg->offset);
+    free(sg->neighbor);
+    free(sg->weight);
+    free(sg);
+}
+
+int get_sparse_num_vertices(SparseGraph *sg) {
+    return sg->num_vertices;
+}
+
+long get_sparse_num_edges(SparseGraph *sg) {
+    return sg->num_edges;
+}
+
+long sparse_begin(SparseGraph *sg, int v) {
+    return sg->offset[v];
+}
+
+long sparse_end(SparseGraph *sg, int v) {
+    return sg->offset[v + 1];
+}
+
+int get_sparse_neighbor(SparseGraph *sg, long i) {
+    return sg->neighbor[i];
+}
+
+EdgeWeight get_sparse_weight(SparseGraph *sg, long i) {
+    return sg->weight[i];
+}
+
+EdgeList *make_sparse_edge_list(SparseGraph *sg) {
+    if (sg->num_edges > INT_MAX)
+        error(1,"make_sparse_edge_list: too many edges for an edge list\n","");
+    EdgeList *el = trial_malloc(sizeof(EdgeList));
+    if (el == NULL)
+        error(1,"make_sparse_edge_list: cannot malloc EdgeList\n","");
+    el->edges = create_edge_array(sg->num_edges);
+
+    int v, w, j = 0;
+    long i;
+    for (v = 0; v < sg->num_vertices; v++) {
+        for (i = sparse_begin(sg, v); i < sparse_end(sg, v); i++) {
+            w = get_sparse_neighbor(sg, i);
+            if (v < w)
+                populate_edge(&el->edges[j++], v, w, get_sparse_weight(sg, i));
+        }
+    }
+    el->num_edges = j;
+    return el;
+}
+
+Edge *pruned_sparse_prim(Graph *g) {
+    int n = get_num_vertices(g);
+    Edge *x = create_edge_array(n - 1);
+    EdgeWeight max_cost = k(n, get_dimension(get_vertex(g, 0)));
+    EdgeWeight growth = 2.0;
+    if (has_squared_weights(g) && max_cost < FLT_MAX) {
+        max_cost = max_cost * max_cost;
+        growth = 4.0;
+    }
+    SparseGraph *sg;
+    int num_mst_edges;
+    while (1) {
+        sg = create_pruned_sparse_graph(g, max_cost);
+        num_mst_edges = sparse_prim(sg, x);
+        destroy_sparse_graph(sg);
+        if (num_mst_edges == n - 1 || max_cost >= FLT_MAX)
+            break;
+        max_cost = growth * max_cost;
+    }
+    return x;
+}
+
+int sparse_kruskal(SparseGraph *sg, Edge *x) {
+    EdgeList *el = make_sparse_edge_list(sg);
+    int num_mst_edges = kruskal_edge_list(sg->num_vertices, el, x);
+    destroy_edge_list(el);
+    return num_mst_edges;
+}
+
+/*
+ * sparse_prim
+ * Grow a tree from every vertex not yet reached, so a disconnected graph
+ * gives its spanning forest. parent[v] is the tree end of v's key edge.
+ */
+int sparse_prim(SparseGraph *sg, Edge *x) {
+    int n = sg->num_vertices, root, u, w, j = 0;
+    long i;
+    VertexHeap *h = create_vertex_heap(n);
+    int *parent = malloc(n * sizeof(int) + 1);
+    char *in_tree = calloc(n + 1, 1);
+    if (parent == NULL || in_tree == NULL)
+        error(1,"sparse_prim: cannot malloc vertex arrays\n","");
+
+    for (root = 0; root < n; root++) {
+        if (in_tree[root])
+            continue;
+        parent[root] = -1;
+        heap_decrease_key(h, root, 0.0);
+        while (h->size > 0) {
+            u = heap_pop(h);
+            in_tree[u] = 1;
+            if (parent[u] >= 0)
+                populate_edge(&x[j++], parent[u], u, h->key[u]);
+            for (i = sparse_begin(sg, u); i < sparse_end(sg, u); i++) {
+                w = get_sparse_neighbor(sg, i);
+                if (!in_tree[w] &&
+                    (h->pos[w] < 0 || get_sparse_weight(sg, i) < h->key[w])) {
+                    parent[w] = u;
+                    heap_decrease_key(h, w, get_sparse_weight(sg, i));
+                }
+            }
+        }
+    }
+
+    free(in_tree);
+    free(parent);
+    destroy_vertex_heap(h);
+    return j;
+}
+
+/*
+ * sparse_boruvka
+ * Each round every component picks its lightest outgoing edge, with ties
+ * broken by endpoints so the picks cannot close a cycle, and all picks
+ * are joined. Rounds stop when no component has an outgoing edge.
+ */
+int sparse_boruvka(SparseGraph *sg, Edge *x) {
+    int n = sg->num_vertices, v, w, cv, cw, j = 0, merged = 1;
+    long i;
+    UnionFind *uf = create_union_find(n);
+    long *lightest = malloc(n * sizeof(long) + 1);  // arc, -1 if none
+    int *source = malloc(n * sizeof(int) + 1);      // the arc's tree end
+    if (lightest == NULL || source == NULL)
+        error(1,"sparse_boruvka: cannot malloc component arrays\n","");
+
+    while (merged && get_num_components(uf) > 1) {
+        for (v = 0; v < n; v++)
+            lightest[v] = -1;
+        for (v = 0; v < n; v++) {
+            cv = uf_find(uf, v);
+            for (i = sparse_begin(sg, v); i < sparse_end(sg, v); i++) {
+                w = get_sparse_neighbor(sg, i);
+                if (uf_find(uf, w) == cv)
+                    continue;
+                if (lightest[cv] < 0 ||
+                    lighter_arc(sg, v, i, source[cv], lightest[cv])) {
+                    lightest[cv] = i;
+                    source[cv] = v;
+                }
+            }
+        }
+
+        merged = 0;
+        for (v = 0; v < n; v++) {
+            if (lightest[v] < 0)
+                continue;
+            cw = get_sparse_neighbor(sg, lightest[v]);
+            if (uf_union(uf, source[v], cw)) {
+                populate_edge(&x[j++], source[v], cw,
+                              get_sparse_weight(sg, lightest[v]));
+                merged = 1;
+            }
+        }
+    }
+
+    free(source);
+    free(lightest);
+    destroy_union_find(uf);
+    return j;
+}
+
+/*
+ * lighter_arc
+ * Return 1 if arc a from u is lighter than arc b from w, comparing the
+ * weight and then the lower and higher endpoints.
+ */
+int lighter_arc(SparseGraph *sg, int u, long a, int w, long b) {
+    EdgeWeight wa = get_sparse_weight(sg, a), wb = get_sparse_weight(sg, b);
+    if (wa != wb)
+        return wa < wb;
+    int a_lo = u, a_hi = get_sparse_neighbor(sg, a);
+    int b_lo = w, b_hi = get_sparse_neighbor(sg, b), t;
+    if (a_lo > a_hi) {
+        t = a_lo; a_lo = a_hi; a_hi = t;
+    }
+    if (b_lo > b_hi) {
+        t = b_lo; b_lo = b_hi; b_hi = t;
+    }
+    if (a_lo != b_lo)
+        return a_lo < b_lo;
+    return a_hi < b_hi;
+}
+
+VertexHeap *create_vertex_heap(int num_vertices) {
+    VertexHeap *h = malloc(sizeof(VertexHeap));
+    if (h == NULL)
+        error(1,"create_vertex_heap: cannot malloc VertexHeap\n","");
+    h->size = 0;
+    h->heap = malloc(num_vertices * sizeof(int) + 1);
+    h->pos = malloc(num_vertices * sizeof(int) + 1);
+    h->key = create_edge_weights(num_vertices + 1);
+    if (h->heap == NULL || h->pos == NULL)
+        error(1,"create_vertex_heap: cannot malloc heap arrays\n","");
+    int v;
+    for (v = 0; v < num_vertices; v++)
+        h->pos[v] = -1;
+    return h;
+}
+
+void destroy_vertex_heap(VertexHeap *h) {
+    free(h->heap);
+    free(h->pos);
+    free(h->key);
+    free(h);
+}
+
+/*
+ * heap_decrease_key
+ * Set v's key, inserting v if it is not in the heap. The key must not be
+ * larger than v's current one.
+ */
+void heap_decrease_key(VertexHeap *h, int v, EdgeWeight key) {
+    h->key[v] = key;
+    if (h->pos[v] < 0)
+        heap_place(h, h->size++, v);
+    heap_sift_up(h, h->pos[v]);
+}
+
+int heap_pop(VertexHeap *h) {
+    int v = h->heap[0];
+    h->pos[v] = -1;
+    if (--h->size > 0) {
+        heap_place(h, 0, h->heap[h->size]);
+        heap_sift_down(h, 0);
+    }
+    return v;
+}
+
+void heap_sift_up(VertexHeap *h, int i) {
+    int v = h->heap[i], parent;
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (h->key[h->heap[parent]] <= h->key[v])
+            break;
+        heap_place(h, i, h->heap[parent]);
+        i = parent;
+    }
+    heap_place(h, i, v);
+}
+
+void heap_sift_down(VertexHeap *h, int i) {
+    int v = h->heap[i], child;
+    while ((child = 2 * i + 1) < h->size) {
+        if (child + 1 < h->size &&
+            h->key[h->heap[child + 1]] < h->key[h->heap[child]])
+            child++;
+        if (h->key[h->heap[child]] >= h->key[v])
+            break;
+        heap_place(h, i, h->heap[child]);
+        i = child;
+    }
+    heap_place(h, i, v);
+}
+
+void heap_place(VertexHeap *h, int i, int v) {
+    h->heap[i] = v;
+    h->pos[v] = i;
+}
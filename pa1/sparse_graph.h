@@ -0,0 +1,71 @@
+typedef struct sparse_graph SparseGraph;
+
+/*
+ * an undirected graph in compressed sparse row form: the neighbors of
+ * vertex v and the weights of the edges to them sit at positions
+ * offset[v] .. offset[v + 1] - 1 of neighbor and weight. Every edge is
+ * stored once from each end, so memory is O(|V| + |E|), not O(|V|^2).
+ */
+struct sparse_graph {
+    int num_vertices;
+    long num_edges;           // undirected edges, half the stored entries
+    long *offset;             // num_vertices + 1 entries
+    int *neighbor;
+    EdgeWeight *weight;
+    int squared_weights;      // 1 if weights are squared distances
+};
+
+/*
+ * create_sparse_graph
+ * Build the sparse graph on num_vertices vertices with the given edges,
+ * in two counting passes over them.
+ */
+SparseGraph *create_sparse_graph(int num_vertices, Edge *edges,
+                                 long num_edges);
+
+/*
+ * create_pruned_sparse_graph
+ * Build the sparse graph of the edges of g no heavier than max_cost, the
+ * edges insert_edges_for_vertex keeps for that threshold.
+ */
+SparseGraph *create_pruned_sparse_graph(Graph *g, EdgeWeight max_cost);
+void destroy_sparse_graph(SparseGraph *sg);
+
+/*
+ * Iterate over the edges at v with
+ *
+ *     for (i = sparse_begin(sg, v); i < sparse_end(sg, v); i++)
+ *         ... get_sparse_neighbor(sg, i), get_sparse_weight(sg, i) ...
+ */
+int get_sparse_num_vertices(SparseGraph *sg);
+long get_sparse_num_edges(SparseGraph *sg);
+long sparse_begin(SparseGraph *sg, int v);
+long sparse_end(SparseGraph *sg, int v);
+int get_sparse_neighbor(SparseGraph *sg, long i);
+EdgeWeight get_sparse_weight(SparseGraph *sg, long i);
+
+/*
+ * make_sparse_edge_list
+ * Return every edge of sg once, from its lower numbered end, as an edge
+ * list for the Kruskal variants.
+ */
+EdgeList *make_sparse_edge_list(SparseGraph *sg);
+
+/*
+ * sparse_kruskal, sparse_prim, sparse_boruvka
+ * Find a minimum spanning forest of sg with Kruskal's algorithm, with Prim
+ * on an indexed binary heap (O(|E| log |V|)), or with Boruvka rounds. The
+ * forest edges go to x, which has room for |V| - 1.
+ * Returns the number of edges written to x, |V| - 1 if sg is connected.
+ */
+int sparse_kruskal(SparseGraph *sg, Edge *x);
+int sparse_prim(SparseGraph *sg, Edge *x);
+int sparse_boruvka(SparseGraph *sg, Edge *x);
+
+/*
+ * pruned_sparse_prim
+ * Like pruned_kruskal, but keeps the edges below the threshold as a sparse
+ * graph and runs sparse_prim on it.
+ * Returns an array of Edge structures with the |V| - 1 MST edges.
+ */
+Edge *pruned_sparse_prim(Graph *g);
@@ -0,0 +1,229 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "utils.h"
+#include "rng.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "union_find.h"
+#include "sparse_interval.h"
+
+typedef struct index_list IndexList;
+
+/* internal structures */
+
+/* a growable array of edge indices */
+struct index_list {
+    uint64_t *items;
+    uint64_t size;
+    uint64_t capacity;
+};
+
+/* internal function prototypes */
+void sample_band(IndexList *band, IndexList *chosen, uint64_t num_edges, 
+                 double q, RandomStream *rs);
+uint64_t geometric_skip(double q, RandomStream *rs);
+void shuffle_indices(IndexList *band, RandomStream *rs);
+int kruskal_band(IndexList *band, EdgeWeight lo, EdgeWeight hi, int n,
+                 UnionFind *uf, Edge *x, int num_mst_edges, RandomStream *rs);
+void merge_indices(IndexList *chosen, IndexList *band);
+void edge_endpoints(uint64_t e, int n, int *u, int *v);
+
+IndexList *create_index_list(uint64_t capacity);
+void reserve_indices(IndexList *list, uint64_t capacity);
+void append_index(IndexList *list, uint64_t e);
+void destroy_index_list(IndexList *list);
+
+/* function definitions */
+
+Edge *sparse_interval_mst(int num_vertices) {
+    int n = num_vertices, mst_size = n - 1, num_mst_edges = 0;
+    Edge *x = create_edge_array(mst_size);
+    if (n < 2)
+        return x;
+
+    uint64_t num_edges = (uint64_t) n * (n - 1) / 2;
+    RandomStream *rs = get_random_stream();
+    UnionFind *uf = create_union_find(n);
+    IndexList *chosen = create_index_list(16);
+    IndexList *band = create_index_list(16);
+
+    EdgeWeight lo = 0.0, hi = k(n, 0);
+    if (hi > 1.0)
+        hi = 1.0;
+    while (num_mst_edges < mst_size) {
+        // each edge not chosen yet has a weight uniform on [lo, 1]
+        sample_band(band, chosen, num_edges, (hi - lo) / (1.0 - lo), rs);
+        if (hi < 1.0)
+            merge_indices(chosen, band);
+        shuffle_indices(band, rs);
+        num_mst_edges = kruskal_band(band, lo, hi, n, uf, x, num_mst_edges, 
+                                     rs);
+        lo = hi;
+        hi = (2 * hi < 1.0) ? 2 * hi : 1.0;
+    }
+
+    destroy_index_list(band);
+    destroy_index_list(chosen);
+    destroy_union_find(uf);
+    return x;
+}
+
+/*
+ * sample_band
+ * Put in band, in increasing order, the indices of the edges not in chosen
+ * that fall in the next weight band, each with probability q.
+ */
+void sample_band(IndexList *band, IndexList *chosen, uint64_t num_edges, 
+                 double q, RandomStream *rs) {
+    uint64_t pos = 0, ci = 0, skip, run_end;
+    band->size = 0;
+    while (1) {
+        // pass over skip edges that are not chosen yet
+        skip = geometric_skip(q, rs);
+        while (1) {
+            while (ci < chosen->size && chosen->items[ci] < pos)
+                ci++;
+            run_end = (ci < chosen->size) ? chosen->items[ci] : num_edges;
+            if (skip < run_end - pos) {
+                pos += skip;
+                break;
+            }
+            skip -= run_end - pos;
+            if (run_end == num_edges) {
+                pos = num_edges;
+                break;
+            }
+            pos = run_end + 1;
+            ci++;
+        }
+        if (pos >= num_edges)
+            return;
+        append_index(band, pos);
+        pos++;
+    }
+}
+
+/*
+ * geometric_skip
+ * return the number of failures before the first success in a sequence of
+ * trials that each succeed with probability q
+ */
+uint64_t geometric_skip(double q, RandomStream *rs) {
+    if (q >= 1.0)
+        return 0;
+    double u = 1.0 - next_random_double(rs); // in (0, 1]
+    double skip = floor(log(u) / log1p(-q));
+    if (skip >= 18446744073709551615.0)
+        return UINT64_MAX;
+    return (uint64_t) skip;
+}
+
+void shuffle_indices(IndexList *band, RandomStream *rs) {
+    uint64_t i, j, tmp;
+    for (i = band->size; i > 1; i--) {
+        j = next_random_bits(rs) % i;
+        tmp = band->items[i-1];
+        band->items[i-1] = band->items[j];
+        band->items[j] = tmp;
+    }
+}
+
+/*
+ * kruskal_band
+ * Give the edges of band, in order, increasing weights uniform on [lo, hi)
+ * and add them to the spanning forest in x, stopping once it is a tree.
+ * The sorted weights are the normalized partial sums of exponential
+ * spacings.
+ * Returns: the number of edges in x.
+ */
+int kruskal_band(IndexList *band, EdgeWeight lo, EdgeWeight hi, int n,
+                 UnionFind *uf, Edge *x, int num_mst_edges, RandomStream *rs) {
+    uint64_t i, num = band->size;
+    double total = 0.0, partial = 0.0, spacing;
+    RandomStream spacings = *rs;
+    // one pass for the sum of the num + 1 spacings, one to hand them out
+    for (i = 0; i <= num; i++)
+        total += -log1p(-next_random_double(rs));
+
+    int u, v;
+    EdgeWeight w;
+    for (i = 0; i < num && num_mst_edges < n - 1; i++) {
+        spacing = -log1p(-next_random_double(&spacings));
+        partial += spacing;
+        edge_endpoints(band->items[i], n, &u, &v);
+        if (uf_union(uf, u, v)) {
+            w = lo + (hi - lo) * (partial / total);
+            populate_edge(&x[num_mst_edges++], u, v, w);
+        }
+    }
+    return num_mst_edges;
+}
+
+/*
+ * merge_indices
+ * add the indices in band to the sorted list chosen, keeping it sorted
+ */
+void merge_indices(IndexList *chosen, IndexList *band) {
+    uint64_t i = chosen->size, j = band->size, out = i + j;
+    reserve_indices(chosen, out);
+    chosen->size = out;
+    // merge from the back so chosen can be filled in place
+    while (j > 0) {
+        if (i > 0 && chosen->items[i-1] > band->items[j-1])
+            chosen->items[--out] = chosen->items[--i];
+        else
+            chosen->items[--out] = band->items[--j];
+    }
+}
+
+/*
+ * edge_endpoints
+ * return in u < v the vertices of edge number e, where the edges are 
+ * numbered row by row through the upper triangle of the n x n matrix
+ */
+void edge_endpoints(uint64_t e, int n, int *u, int *v) {
+    double b = 2.0 * n - 1.0;
+    int64_t row = (int64_t) ((b - sqrt(b * b - 8.0 * (double) e)) / 2.0);
+    // first edge of row r is r * (2n - r - 1) / 2; fix rounding either way
+    while (row > 0 && (uint64_t) (row * (2 * (int64_t) n - row - 1) / 2) > e)
+        row--;
+    while ((uint64_t) ((row + 1) * (2 * (int64_t) n - row - 2) / 2) <= e)
+        row++;
+    *u = (int) row;
+    *v = (int) (e - row * (2 * (int64_t) n - row - 1) / 2 + row + 1);
+}
+
+IndexList *create_index_list(uint64_t capacity) {
+    IndexList *list = malloc(sizeof(IndexList));
+    if (list == NULL)
+        error(1,"create_index_list: cannot malloc IndexList\n","");
+    list->items = malloc(capacity * sizeof(uint64_t));
+    if (list->items == NULL)
+        error(1,"create_index_list: cannot malloc items\n","");
+    list->size = 0;
+    list->capacity = capacity;
+    return list;
+}
+
+void reserve_indices(IndexList *list, uint64_t capacity) {
+    if (capacity <= list->capacity)
+        return;
+    list->items = realloc(list->items, capacity * sizeof(uint64_t));
+    if (list->items == NULL)
+        error(1,"reserve_indices: cannot realloc items\n","");
+    list->capacity = capacity;
+}
+
+void append_index(IndexList *list, uint64_t e) {
+    if (list->size == list->capacity)
+        reserve_indices(list, 2 * list->capacity);
+    list->items[list->size++] = e;
+}
+
+void destroy_index_list(IndexList *list) {
+    free(list->items);
+    free(list);
+}
@@ -0,0 +1,18 @@
+
+/*
+ * sparse_interval_mst
+ * Determine an MST of a random complete graph on num_vertices vertices 
+ * whose edge weights are independent and uniform on [0,1] (dimension 0) 
+ * without drawing all n^2 / 2 weights. Only the edges below a threshold 
+ * around k(n, 0) are sampled, in weight bands [lo, hi):
+ *   - which edges fall in the band is decided by geometric skips over the 
+ *     edge index space, so untouched edges cost nothing,
+ *   - the band's weights are generated already sorted and handed out to 
+ *     its edges in random order,
+ *   - Kruskal runs on the band as it is generated.
+ * If the vertices are still not connected, the next band [hi, 2 hi) is 
+ * sampled from the edges not chosen so far, which keeps every weight 
+ * independent and uniform. Expected time and memory are O(n log n).
+ * Returns an array of Edge structures with the |V| - 1 MST edges.
+ */
+Edge *sparse_interval_mst(int num_vertices);
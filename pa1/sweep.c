@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <limits.h>
+
+#include "utils.h"
+#include "graph.h"
+#include "random_graph.h"
+#include "kruskal.h"
+#include "distance.h"
+#include "sweep.h"
+
+/* internal function prototypes */
+int add_vertex_edges(Graph *g, int squared, int v, Edge *edges, int count,
+                     EdgeWeight *row);
+
+/* function definitions */
+
+void sweep_mst_weights(int dim, int *sizes, int num_sizes, int squared,
+                       EdgeWeight *weight) {
+    int max_n = sizes[num_sizes - 1], prev_n = 0, n, k, v, i;
+    Graph *g = create_random_point_graph(dim, max_n);
+    Edge *mst = create_edge_array(max_n);
+    EdgeWeight *row = create_edge_weights(max_n);
+    int num_mst_edges = 0;
+
+    for (k = 0; k < num_sizes; k++) {
+        n = sizes[k];
+        if (n < prev_n)
+            error(1,"sweep_mst_weights: sizes must increase\n","");
+
+        // candidates: the last MST and every edge to a new vertex
+        long num_candidates = num_mst_edges + triangular_number(n - 1) - 
+                              triangular_number(prev_n - 1);
+        if (num_candidates > INT_MAX)
+            error(1,"sweep_mst_weights: too many edges for memory\n","");
+        EdgeList el;
+        el.edges = create_edge_array(num_candidates);
+        el.num_edges = 0;
+        for (i = 0; i < num_mst_edges; i++)
+            el.edges[el.num_edges++] = mst[i];
+        for (v = prev_n; v < n; v++)
+            el.num_edges = add_vertex_edges(g, squared, v, el.edges, 
+                                            el.num_edges, row);
+
+        num_mst_edges = kruskal_edge_list(n, &el, mst);
+        destroy_edge_array(el.edges);
+
+        EdgeWeight total = 0.0;
+        for (i = 0; i < num_mst_edges; i++)
+            total += squared ? sqrtf(get_cost(&mst[i])) : get_cost(&mst[i]);
+        weight[k] = total;
+        prev_n = n;
+    }
+
+    free(row);
+    destroy_edge_array(mst);
+    destroy_graph(g);
+}
+
+/*
+ * add_vertex_edges
+ * Append the edges from v to every vertex before it to edges[count ..], 
+ * in the same orientation as make_graph_edge_list (lower index first).
+ * Returns the new count.
+ */
+int add_vertex_edges(Graph *g, int squared, int v, Edge *edges, int count,
+                     EdgeWeight *row) {
+    int u, dim = g->dimension;
+    if (v == 0)
+        return count;
+    if (dim > 0)
+        distance_row(g->coord, get_num_vertices(g), dim, v, 0, v, squared, 
+                     row);
+    for (u = 0; u < v; u++)
+        populate_edge(&edges[count++], u, v, 
+                      (dim > 0) ? row[u] : random_float(0,1));
+    return count;
+}
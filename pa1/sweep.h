@@ -0,0 +1,14 @@
+/*
+ * sweep_mst_weights
+ * Draw one random graph on sizes[num_sizes - 1] vertices in dimension dim
+ * and set weight[k] to the MST weight of its first sizes[k] vertices, for
+ * sizes in increasing order. Adding vertices can only bring in edges that
+ * touch them, so each prefix is solved from the previous prefix's MST and
+ * the edges of its new vertices alone, and the whole sweep costs about as
+ * much as its largest size. For dimensions 2 and up a prefix is the same 
+ * graph create_random_graph makes with that many vertices from the same 
+ * random stream; for dimension 0 the weights are drawn a vertex at a time.
+ * With squared set, distances are sorted squared and rooted in the sum.
+ */
+void sweep_mst_weights(int dim, int *sizes, int num_sizes, int squared,
+                       EdgeWeight *weight);
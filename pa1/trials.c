@@ -0,0 +1,273 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "graph.h"
+#include "kruskal.h"
+#include "graph_file.h"
+#include "engine.h"
+#include "parallel.h"
+#include "sweep.h"
+#include "trials.h"
+
+#define MIN_ADAPTIVE_TRIALS 10  // before this the variance is too rough
+#define CI_Z 1.96               // two-sided 95% normal quantile
+#define T_TABLE_DF 30           // degrees of freedom with tabled quantiles
+
+/* two-sided 95% Student t quantiles for 1 .. T_TABLE_DF degrees of freedom */
+static const double t_quantiles[T_TABLE_DF] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+typedef struct trial_pool TrialPool;
+typedef struct sweep_pool SweepPool;
+
+/* internal structures */
+struct trial_pool {
+    Engine engine;
+    int dim;
+    int num_vertices;
+    int numtrials;
+    unsigned long seed;
+    int next_trial;         // next trial to hand out, taken atomically
+    EdgeWeight *weight;     // MST weight of each trial
+
+    /* adaptive runs only: trials are folded into stats in trial order */
+    double target_width;    // 0 to run all numtrials
+    char *done;             // done[i] once weight[i] is set
+    int next_fold;          // first trial not yet in stats
+    int stop;               // set once stats has converged
+    TrialStats *stats;
+    pthread_mutex_t lock;
+};
+
+/* the trials of a size sweep, each over all the sizes */
+struct sweep_pool {
+    int dim;
+    int *sizes;
+    int num_sizes;
+    unsigned long seed;
+    int squared;
+    EdgeWeight *weight;     // trial t, size k at t * num_sizes + k
+};
+
+/* internal function prototypes */
+void *trial_worker(void *arg);
+void sweep_trial(int trial, void *arg);
+void fold_trials(TrialPool *pool, int i);
+double t_quantile(long df);
+
+/* function definitions */
+
+double run_trials(Engine e, int dim, int num_vertices, int numtrials,
+                  int num_threads, unsigned long seed) {
+    TrialPool pool;
+    pool.engine = e;
+    pool.dim = dim;
+    pool.num_vertices = num_vertices;
+    pool.numtrials = numtrials;
+    pool.seed = seed;
+    pool.next_trial = 0;
+    pool.weight = create_edge_weights(numtrials);
+    pool.target_width = 0.0;
+    pool.stop = 0;
+
+    if (num_threads > numtrials)
+        num_threads = numtrials;
+    run_parallel(num_threads, trial_worker, &pool);
+
+    double avg = 0.0;
+    int i;
+    for (i = 0; i < numtrials; i++) {
+        avg = avg + pool.weight[i];
+    }
+    avg = avg / numtrials;
+
+    free(pool.weight);
+    return avg;
+}
+
+/*
+ * run_adaptive_trials
+ * A trial's weight is only folded in once every earlier trial has been, 
+ * so the trials used, and the mean, do not depend on num_threads. Trials
+ * that finish after the stop are discarded.
+ */
+int run_adaptive_trials(Engine e, int dim, int num_vertices, 
+                        double target_width, int max_trials, 
+                        int num_threads, unsigned long seed, 
+                        TrialStats *stats) {
+    TrialPool pool;
+    pool.engine = e;
+    pool.dim = dim;
+    pool.num_vertices = num_vertices;
+    pool.numtrials = max_trials;
+    pool.seed = seed;
+    pool.next_trial = 0;
+    pool.weight = create_edge_weights(max_trials);
+    pool.target_width = target_width;
+    pool.done = calloc(max_trials, 1);
+    if (pool.done == NULL)
+        error(1,"run_adaptive_trials: cannot malloc done flags\n","");
+    pool.next_fold = 0;
+    pool.stop = 0;
+    pool.stats = stats;
+    init_trial_stats(stats);
+    pthread_mutex_init(&pool.lock, NULL);
+
+    if (num_threads > max_trials)
+        num_threads = max_trials;
+    run_parallel(num_threads, trial_worker, &pool);
+
+    pthread_mutex_destroy(&pool.lock);
+    free(pool.done);
+    free(pool.weight);
+    return (int) stats->count;
+}
+
+/*
+ * fold_trials
+ * Record that trial i is done and fold every trial that is now next in 
+ * order into the statistics, stopping as soon as they converge.
+ */
+void fold_trials(TrialPool *pool, int i) {
+    pthread_mutex_lock(&pool->lock);
+    pool->done[i] = 1;
+    while (!pool->stop && pool->next_fold < pool->numtrials && 
+           pool->done[pool->next_fold]) {
+        add_trial_stat(pool->stats, pool->weight[pool->next_fold++]);
+        if (pool->stats->count >= MIN_ADAPTIVE_TRIALS && 
+            get_relative_ci_width(pool->stats) <= pool->target_width)
+            __atomic_store_n(&pool->stop, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void init_trial_stats(TrialStats *s) {
+    s->count = 0;
+    s->mean = 0.0;
+    s->m2 = 0.0;
+}
+
+/*
+ * add_trial_stat
+ * Welford's update: one pass, and no cancellation between large sums.
+ */
+void add_trial_stat(TrialStats *s, double x) {
+    s->count++;
+    double delta = x - s->mean;
+    s->mean += delta / s->count;
+    s->m2 += delta * (x - s->mean);
+}
+
+double get_trial_variance(TrialStats *s) {
+    return (s->count > 1) ? s->m2 / (s->count - 1) : 0.0;
+}
+
+/*
+ * get_ci_half_width
+ * half the width of the 95% confidence interval for the mean. The 
+ * variance is estimated from the trials themselves, so the interval uses
+ * Student's t, which is much wider than the normal one after 10 trials.
+ */
+double get_ci_half_width(TrialStats *s) {
+    if (s->count < 2)
+        return INFINITY;
+    return t_quantile(s->count - 1) * sqrt(get_trial_variance(s) / s->count);
+}
+
+/*
+ * t_quantile
+ * the two-sided 95% Student t quantile for df degrees of freedom: from 
+ * the table up to T_TABLE_DF, past it from the Cornish-Fisher expansion 
+ * around the normal quantile, within 1e-4 there
+ */
+double t_quantile(long df) {
+    if (df <= T_TABLE_DF)
+        return t_quantiles[df - 1];
+    double z = CI_Z, z3 = z * z * z, z5 = z3 * z * z;
+    return z + (z3 + z) / (4.0 * df) 
+             + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * df * df);
+}
+
+double get_relative_ci_width(TrialStats *s) {
+    if (s->mean == 0.0)
+        return INFINITY;
+    return 2.0 * get_ci_half_width(s) / fabs(s->mean);
+}
+
+void run_sweep_trials(int dim, int *sizes, int num_sizes, int numtrials,
+                      int num_threads, unsigned long seed, double *avg) {
+    SweepPool pool;
+    pool.dim = dim;
+    pool.sizes = sizes;
+    pool.num_sizes = num_sizes;
+    pool.seed = seed;
+    pool.squared = get_squared_distances() && dim != 0;
+    pool.weight = create_edge_weights(numtrials * num_sizes);
+
+    parallel_for(numtrials, num_threads, sweep_trial, &pool);
+
+    int t, k;
+    for (k = 0; k < num_sizes; k++) {
+        avg[k] = 0.0;
+        for (t = 0; t < numtrials; t++)
+            avg[k] = avg[k] + pool.weight[t * num_sizes + k];
+        avg[k] = avg[k] / numtrials;
+    }
+    free(pool.weight);
+}
+
+void sweep_trial(int trial, void *arg) {
+    SweepPool *pool = arg;
+    set_random_stream(pool->seed, trial);
+    sweep_mst_weights(pool->dim, pool->sizes, pool->num_sizes, pool->squared,
+                      &pool->weight[trial * pool->num_sizes]);
+}
+
+void write_trial_graphs(char *path, int dim, int num_vertices, 
+                        int numtrials, unsigned long seed) {
+    char *name = malloc(strlen(path) + 16);
+    if (name == NULL)
+        error(1,"write_trial_graphs: cannot malloc file name\n","");
+    int i;
+    for (i = 0; i < numtrials; i++) {
+        if (numtrials == 1)
+            strcpy(name, path);
+        else
+            sprintf(name, "%s.%d", path, i);
+        set_random_stream(seed, i);
+        Graph *g = create_matrix_graph(dim, num_vertices);
+        write_graph_file(name, g);
+        destroy_graph(g);
+    }
+    free(name);
+}
+
+void *trial_worker(void *arg) {
+    TrialPool *pool = arg;
+    // every trial has the same size, so after the first one the arena 
+    // holds all of a trial's graph, edge list, union-find and MST buffers
+    Arena *arena = create_arena(0);
+    set_trial_arena(arena);
+    int i;
+    while (!__atomic_load_n(&pool->stop, __ATOMIC_RELAXED) &&
+           (i = __atomic_fetch_add(&pool->next_trial, 1, __ATOMIC_RELAXED)) 
+           < pool->numtrials) {
+        reset_arena(arena);
+        set_random_stream(pool->seed, i);
+        pool->weight[i] = random_mst_weight(pool->engine, pool->dim, 
+                                            pool->num_vertices);
+        if (pool->target_width > 0.0)
+            fold_trials(pool, i);
+    }
+    set_trial_arena(NULL);
+    destroy_arena(arena);
+    return NULL;
+}
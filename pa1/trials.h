@@ -0,0 +1,59 @@
+
+/*
+ * run_trials
+ * Compute the MST weight of numtrials random graphs with engine e on 
+ * num_threads worker threads. Each worker holds one graph at a time, so 
+ * memory grows with num_threads, not numtrials. Trial i draws its graph 
+ * from random stream i of seed and the weights are summed in trial order,
+ * so the mean depends only on seed, not on num_threads.
+ * Returns: the mean MST weight.
+ */
+double run_trials(Engine e, int dim, int num_vertices, int numtrials,
+                  int num_threads, unsigned long seed);
+
+typedef struct trial_stats TrialStats;
+
+/* running mean and variance of trial weights (Welford) */
+struct trial_stats {
+    long count;
+    double mean;
+    double m2;              // sum of squared deviations from the mean
+};
+
+void init_trial_stats(TrialStats *s);
+void add_trial_stat(TrialStats *s, double x);
+double get_trial_variance(TrialStats *s);
+double get_ci_half_width(TrialStats *s);
+double get_relative_ci_width(TrialStats *s);
+
+/*
+ * run_adaptive_trials
+ * Like run_trials, but stop once the 95% confidence interval for the mean
+ * is no wider than target_width times the mean, after at least 10 and at
+ * most max_trials trials. stats gets the mean and variance of the trials 
+ * used, in trial order.
+ * Returns: the number of trials used.
+ */
+int run_adaptive_trials(Engine e, int dim, int num_vertices, 
+                        double target_width, int max_trials, 
+                        int num_threads, unsigned long seed, 
+                        TrialStats *stats);
+
+/*
+ * run_sweep_trials
+ * Run numtrials size sweeps (see sweep_mst_weights) over the increasing 
+ * sizes, trial i on random stream i of seed, on num_threads threads, and 
+ * set avg[k] to the mean MST weight at sizes[k].
+ */
+void run_sweep_trials(int dim, int *sizes, int num_sizes, int numtrials,
+                      int num_threads, unsigned long seed, double *avg);
+
+/*
+ * write_trial_graphs
+ * Save the weight matrix graphs of trials 0 .. numtrials - 1 to graph 
+ * files, path itself for a single trial and path.i for trial i otherwise.
+ * These are the graphs every engine for which solves_matrix_graph holds 
+ * solves from the same seed.
+ */
+void write_trial_graphs(char *path, int dim, int num_vertices, 
+                        int numtrials, unsigned long seed);
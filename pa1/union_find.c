@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "union_find.h"
+
+UnionFind *create_union_find(int num_items) {
+    UnionFind *uf = trial_malloc(sizeof(UnionFind));
+    if (uf == NULL)
+        error(1,"create_union_find: cannot malloc UnionFind\n","");
+    uf->parent = trial_malloc(num_items * sizeof(int32_t) + 1);
+    uf->size = trial_malloc(num_items * sizeof(int32_t) + 1);
+    if (uf->parent == NULL || uf->size == NULL)
+        error(1,"create_union_find: cannot malloc index arrays\n","");
+
+    int i;
+    for (i = 0; i < num_items; i++) {
+        uf->parent[i] = i;
+        uf->size[i] = 1;
+    }
+    uf->num_items = num_items;
+    uf->num_sets = num_items;
+    return uf;
+}
+
+void destroy_union_find(UnionFind *uf) {
+    trial_free(uf->size);
+    trial_free(uf->parent);
+    trial_free(uf);
+}
+
+int get_num_components(UnionFind *uf) {
+    return uf->num_sets;
+}
+
+/*
+ * uf_find
+ * return the root of x's set, pointing every other node on the way at its
+ * grandparent (path halving), without recursion
+ */
+int uf_find(UnionFind *uf, int x) {
+    int32_t *parent = uf->parent;
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/*
+ * uf_union
+ * merge the sets of x and y, the smaller under the larger
+ * Returns: 1 if they were in different sets, 0 if nothing changed.
+ */
+int uf_union(UnionFind *uf, int x, int y) {
+    x = uf_find(uf, x);
+    y = uf_find(uf, y);
+    if (x == y)
+        return 0;
+    if (uf->size[x] > uf->size[y]) {
+        int temp = x;
+        x = y;
+        y = temp;
+    }
+    uf->parent[x] = y;
+    uf->size[y] += uf->size[x];
+    uf->num_sets--;
+    return 1;
+}
+
+int uf_find_concurrent(UnionFind *uf, int x) {
+    int32_t *parent = uf->parent;
+    int32_t p, gp;
+    p = __atomic_load_n(&parent[x], __ATOMIC_ACQUIRE);
+    while (p != x) {
+        gp = __atomic_load_n(&parent[p], __ATOMIC_ACQUIRE);
+        // halve the path if nobody else changed it; failing is harmless
+        __atomic_compare_exchange_n(&parent[x], &p, gp, 0, 
+                                    __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        x = gp;
+        p = __atomic_load_n(&parent[x], __ATOMIC_ACQUIRE);
+    }
+    return x;
+}
+
+int uf_union_concurrent(UnionFind *uf, int x, int y) {
+    int32_t root;
+    while (1) {
+        x = uf_find_concurrent(uf, x);
+        y = uf_find_concurrent(uf, y);
+        if (x == y)
+            return 0;
+        if (x > y) {
+            int temp = x;
+            x = y;
+            y = temp;
+        }
+        // link x under y only if x is still a root, otherwise start over
+        root = x;
+        if (__atomic_compare_exchange_n(&uf->parent[x], &root, y, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_fetch_add(&uf->size[y], 
+                               __atomic_load_n(&uf->size[x], __ATOMIC_RELAXED),
+                               __ATOMIC_RELAXED);
+            __atomic_fetch_sub(&uf->num_sets, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+    }
+}
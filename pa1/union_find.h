@@ -0,0 +1,33 @@
+#include <stdint.h>
+
+typedef struct union_find UnionFind;
+
+/*
+ * union-find over the items 0 .. num_items - 1, stored as plain index 
+ * arrays: parent[i] == i marks a root, and size[r] counts the items in 
+ * root r's set.
+ */
+struct union_find {
+    int32_t num_items;
+    int32_t num_sets;
+    int32_t *parent;
+    int32_t *size;
+};
+
+/* function prototypes */
+UnionFind *create_union_find(int num_items);
+void destroy_union_find(UnionFind *uf);
+int get_num_components(UnionFind *uf);
+
+int uf_find(UnionFind *uf, int x);
+int uf_union(UnionFind *uf, int x, int y);
+
+/*
+ * lock-free variants that any number of threads may call at once on the 
+ * same UnionFind. Roots are linked with compare-and-swap, always the lower
+ * index under the higher one, so two threads can never link a cycle. Do 
+ * not mix with uf_union while other threads are running. The size array
+ * is only kept exact by uf_union.
+ */
+int uf_find_concurrent(UnionFind *uf, int x);
+int uf_union_concurrent(UnionFind *uf, int x, int y);
@@ -2,20 +2,40 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-#include <math.h>
 #include "utils.h"
+#include "rng.h"
+
+/* the random stream random_float draws from, one per thread */
+static __thread RandomStream random_state;
+
+/*
+ * set_random_stream
+ * make the calling thread's random_float draw from stream number stream of
+ * seed. Different (seed, stream) pairs give independent sequences.
+ */
+void set_random_stream(unsigned long seed, unsigned long stream) {
+    init_random_stream(&random_state, seed, stream);
+}
+
+/*
+ * get_random_stream
+ * return the calling thread's stream, for code that draws from it directly
+ */
+RandomStream *get_random_stream(void) {
+    return &random_state;
+}
 
 /*
  * random_float
- * return a random float in the interval [a, b]
- * caller must set random seed
+ * return a random float in the interval [a, b)
+ * caller must pick a stream, per thread, with set_random_stream
  */
 float random_float(float a, float b) {
     if (b < a)
         return 0;
-    /* make random number in [0,1] */
-    float ran_fraction = (1.0 * random()) / RAND_MAX;
-    /* scale it to be in interval [a,b] */
+    /* make random number in [0,1) */
+    float ran_fraction = next_random_float(&random_state);
+    /* scale it to be in interval [a,b) */
     return (a + (b - a) * ran_fraction);
 }
 
@@ -33,27 +53,12 @@ float *create_float_array(int n) {
     return fp; 
 }
 
-/*
- * euclidean_distance
- * input: float arrays x and y that have equal length equal to dimension
- * returns: euclidean distance between the points represented by x and y
- */
-float euclidean_distance(float *x, float *y, int dimension) {
-    float dist2 = 0.0, diff;
-    int i;
-    for (i = 0; i < dimension; i++) {
-        diff = x[i] - y[i];
-        dist2 = dist2 + (diff * diff);
-    }
-    return sqrt(dist2);
-}
-
 /*
  * triangular_number
  * return the sum of the integers from 1 to n (the nth triangular number)
  */
-int triangular_number(int n) {
-    return (n * (n+1)) / 2;
+long triangular_number(long n) {
+    return (n * (n+1)) / 2; // long: n * (n+1) passes 2^31 at n = 46341
 }
 
 /*
@@ -64,15 +69,3 @@ void error(int errcd, char *msg1, char *msg2) {
     printf("%s %s",msg1, msg2);
     exit(errcd);
 }
-
-/*
-int main() {
-    float x1[2] = {0.0, 0.0};
-    float x2[2] = {1.0, 1.0};
-
-    float d = euclidean_distance(x1, x2, 2);
-    printf("sqrt 2: %f\n",sqrt(2));
-    printf("ed: %f\n",d);
-    return 0;
-}
-*/
@@ -1,7 +1,10 @@
 
+typedef struct random_stream RandomStream;
+
+void set_random_stream(unsigned long seed, unsigned long stream);
+RandomStream *get_random_stream(void);
 float random_float(float a, float b);
 float *create_float_array(int n);
 void error(int errcd, char *msg1, char *msg2);
-float euclidean_distance(float *x, float *y, int dimension);
-int triangular_number(int n);
+long triangular_number(long n);
 